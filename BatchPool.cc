@@ -0,0 +1,364 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   BatchPool.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Multithreaded batch solver. The main thread cuts the
+ *                  input into chunks of puzzle lines and puts them in a ring
+ *                  of slots (the reorder window). Each worker thread has its
+ *                  own SudokuSolver. It takes puzzles from the chunks it
+ *                  owns (chunk number modulo thread count) and, when those
+ *                  run dry, steals the unclaimed puzzles of the other
+ *                  chunks, so one slow puzzle does not idle the other cores.
+ *                  The main thread writes the chunks back strictly in input
+ *                  order as they complete and then reuses the slot.
+ *
+ *                  Puzzles are claimed with a compare-and-swap on a per
+ *                  chunk word holding the chunk's count and next unclaimed
+ *                  puzzle. Locks are only taken to sleep and wake threads.
+ *
+ *                  With a MappedLineReader a chunk is just a list of line
+ *                  boundaries inside the mapped file and the workers parse
+ *                  straight from the mapped pages. Other readers have their
+ *                  lines copied into the chunk.
+ *
+ *                  The pool is a template on the block size like the
+ *                  solver; BatchPool is the 9x9 instance. In lane mode
+ *                  (9x9 only) each worker claims LANES puzzles at a time
+ *                  and runs them through a LaneSolver.
+ *
+ *                  Every worker solver gets the pool's SolveLimits, so a
+ *                  puzzle that would run away fails with SOLVE_BUDGET and
+ *                  frees its worker for the next one, and its technique
+ *                  passes (see TechniqueRater.cc). With a SolutionCache
+ *                  (9x9 only, not in lane mode) the workers share it and
+ *                  each has its own PuzzleCanonizer. With a
+ *                  PackedRecordWriter the results go out as packed records
+ *                  (see PackedIO.cc) instead of lines.
+ *
+ *                  The solvers belong to the pool, one WorkerState per
+ *                  worker, and outlive the threads of a run. A pool that
+ *                  is run again starts with warm solvers, and a worker
+ *                  allocates nothing from one puzzle to the next.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef BATCHPOOL_CC
+#define BATCHPOOL_CC
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+#include "PuzzleIO.cc"      // One-line-per-puzzle format.
+#include "PuzzleReader.cc"  // Line readers.
+#include "StatsSummary.cc"  // Solve statistics.
+#include "LaneSolver.cc"    // Lane parallel logical solver.
+#include "SolutionCache.cc" // Canonical form solution cache.
+#include "PackedIO.cc"      // Packed binary puzzle files.
+
+#define BATCH_CHUNK     256     // Puzzle lines per chunk
+#define BATCH_GRAB      4       // Puzzles claimed from a chunk at a time
+
+template <int B>
+class BasicBatchPool {
+
+    public:
+
+        typedef BasicSudokuSolver<B> Solver;
+        static constexpr int LINE = Solver::CELLS;  // Characters of one puzzle line
+
+        /*  One slot of the reorder window. The input fields are written by
+         *  the main thread before 'claim' is published and stay untouched
+         *  until every puzzle of the chunk is done.
+         */
+        struct Chunk {
+            std::atomic<uint64_t>   claim;  // seq << 32 | count << 16 | next unclaimed puzzle
+            std::atomic<uint32_t>   done;   // Puzzles of the chunk finished
+            uint32_t                count;  // Puzzles in the chunk
+            const char             *line [BATCH_CHUNK];     // Start of each puzzle line
+            uint16_t                length [BATCH_CHUNK];   // Line length without newline
+            long                    lineNo [BATCH_CHUNK];   // Line number for errors
+            uint8_t                 status [BATCH_CHUNK];   // Solve status per puzzle
+            SolveConflict           conflict [BATCH_CHUNK]; // Where a failed puzzle went wrong
+            uint32_t                nodes [BATCH_CHUNK];    // Search nodes per puzzle, 0 in lane mode
+            char                    text [BATCH_CHUNK * LINE];          // Copied lines of unstable readers
+            char                    out [BATCH_CHUNK * (LINE + 1)];
+        };
+
+        /*  What one worker solves with. It is made with the pool and kept
+         *  from run to run.
+         */
+        struct WorkerState {
+            Solver                  SS;
+            LaneSolver             *LS;     // Lane mode only
+            PuzzleCanonizer        *canon;  // Made on the first run with a cache
+        };
+
+        int                     threads;    // Worker threads
+        bool                    unique;     // Reject puzzles with several solutions
+        SolveLimits             limits;     // Limits of every solve
+        SolutionCache          *cache;      // Shared by the workers, NULL for none (9x9 only)
+        PackedRecordWriter     *packed;     // Writes records instead of lines, NULL for text
+        bool                    lanes;      // Solve on LaneSolvers (9x9 only)
+        int                     techniques; // TechniqueTier passes of every solve
+        uint32_t                grab;       // Puzzles claimed at a time
+        int                     window;     // Chunks in flight
+        Chunk                  *chunks;     // Ring of 'window' slots
+        std::atomic<uint32_t>   retired;    // Oldest chunk not written yet
+        std::atomic<uint32_t>   published;  // Chunks handed to the workers
+        bool                    stopping;   // Set under 'lock' when the input is done
+        std::mutex              lock;
+        std::condition_variable workReady;  // Signalled when a chunk is published
+        std::condition_variable chunkDone;  // Signalled when a chunk completes
+        WorkerState            *states;     // Per worker solvers
+        StatsSummary           *summaries;  // Per worker statistics (SUDOKU_STATS)
+        StatsSummary            summary;    // All workers, filled in by run()
+
+    BasicBatchPool (int threadCount, bool uniqueCheck = false, bool laneMode = false) {
+        threads = threadCount < 1 ? 1 : threadCount;
+        unique = uniqueCheck;
+        limits = SolveLimits { 0, 0, NULL };
+        cache = NULL;
+        packed = NULL;
+        lanes = laneMode && B == 3;
+        techniques = 0;
+        grab = lanes ? LANES : BATCH_GRAB;
+        window = 2 * threads + 2;
+        chunks = new Chunk [window];
+        states = new WorkerState [threads];
+        summaries = new StatsSummary [threads];
+        for (int k = 0; k < threads; k++) {
+            states[k].LS = lanes ? new LaneSolver : NULL;
+            states[k].canon = NULL;
+        }
+        for (int k = 0; k < window; k++) {
+            chunks[k].claim.store (0);
+            chunks[k].done.store (0);
+            chunks[k].count = 0;
+        }
+        retired.store (0);
+        published.store (0);
+        stopping = false;
+    }
+
+    ~BasicBatchPool (void) {
+        for (int k = 0; k < threads; k++) {
+            delete states[k].LS;
+            delete states[k].canon;
+        }
+        delete [] states;
+        delete [] chunks;
+        delete [] summaries;
+    }
+
+    /*  This method reads every puzzle line from 'in', solves them on the
+     *  worker threads and writes the results to 'out' in input order.
+     *  Failing puzzles are reported on stderr by line number. It returns the
+     *  number of puzzles that failed.
+     */
+    template <class Reader>
+    long run (Reader &in, OutputBuffer &out) {
+        std::vector<std::thread> workers;
+        long failed = 0;
+        uint32_t fill = 0, write = 0;
+        bool eof = false;
+
+        stopping = false;
+        for (int k = 0; k < threads; k++)
+            workers.push_back (std::thread (&BasicBatchPool::worker, this, k));
+
+        while (true) {
+            while (!eof && fill - write < (uint32_t) window) { // Keep the window full.
+                Chunk &c = chunks[fill % window];
+                eof = !readChunk (in, c);
+                if (c.count == 0)
+                    break;
+                publish (c, fill++);
+            }
+            if (write == fill)
+                break;
+
+            Chunk &c = chunks[write % window];
+            {
+                std::unique_lock<std::mutex> guard (lock);
+                while (c.done.load (std::memory_order_acquire) != c.count)
+                    chunkDone.wait (guard);
+            }
+            for (uint32_t k = 0; k < c.count; k++)
+                if (c.status[k] != SOLVE_OK) {
+                    char where [96];
+                    cerr << "Error: line " << c.lineNo[k] << ": " << statusMessage (c.status[k])
+                         << describeConflict<Solver::NUM> (c.conflict[k], where, sizeof (where)) << endl;
+                    failed++;
+                }
+            if (packed != NULL)
+                for (uint32_t k = 0; k < c.count; k++)
+                    packed->put (c.out + k * (LINE + 1), c.status[k], c.nodes[k]);
+            else
+                out.put (c.out, c.count * (LINE + 1));
+            retired.store (++write, std::memory_order_release);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            stopping = true;
+        }
+        workReady.notify_all ();
+        for (size_t k = 0; k < workers.size (); k++)
+            workers[k].join ();
+        SUDOKU_STAT (for (int k = 0; k < threads; k++) summary.merge (summaries[k]));
+        return failed;
+    }
+
+    /*  This method fills the chunk with up to BATCH_CHUNK puzzle lines.
+     *  Lines of a stable reader are referenced in place. Otherwise only the
+     *  first LINE characters are copied, that is all the parser looks at. It
+     *  returns false once the input is exhausted.
+     */
+    template <class Reader>
+    bool readChunk (Reader &in, Chunk &c) {
+        const char *line;
+        size_t len;
+        c.count = 0;
+        while (c.count < BATCH_CHUNK) {
+            if (!in.next (line, len))
+                return false;
+            if (len > LINE)
+                len = LINE;
+            if (!Reader::STABLE) {
+                char *text = c.text + c.count * LINE;
+                memcpy (text, line, len);
+                line = text;
+            }
+            c.line[c.count] = line;
+            c.length[c.count] = (uint16_t) len;
+            c.lineNo[c.count] = in.lineNo;
+            c.count++;
+        }
+        return true;
+    }
+
+    /*  This method hands a filled chunk to the workers.
+     */
+    void publish (Chunk &c, uint32_t seq) {
+        c.done.store (0, std::memory_order_relaxed);
+        c.claim.store (((uint64_t) seq << 32) | ((uint64_t) c.count << 16), std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            published.fetch_add (1);
+        }
+        workReady.notify_all ();
+    }
+
+    /*  This is the loop of one worker thread. It keeps claiming puzzles and
+     *  sleeps only when no chunk in the window has unclaimed puzzles left.
+     */
+    void worker (int id) {
+        WorkerState &w = states[id];
+        if (cache != NULL && B == 3 && !lanes && w.canon == NULL)
+            w.canon = new PuzzleCanonizer;
+        PuzzleCanonizer *canon = cache != NULL ? w.canon : NULL;
+        w.SS.limits = limits;
+        w.SS.techniques = techniques;
+        if (w.LS != NULL) {
+            w.LS->scalar.limits = limits;
+            w.LS->scalar.techniques = techniques;
+        }
+        while (true) {
+            uint32_t seen = published.load ();
+            if (claimWork (id, w.SS, w.LS, canon))
+                continue;
+            std::unique_lock<std::mutex> guard (lock);
+            while (!stopping && published.load () == seen)
+                workReady.wait (guard);
+            if (stopping)
+                break;
+        }
+    }
+
+    /*  This method claims a few puzzles and solves them. The first pass only
+     *  looks at the chunks owned by this worker, the second pass steals
+     *  from any chunk, oldest first so the writer is never held up for
+     *  long. It returns false if there was nothing to claim.
+     */
+    bool claimWork (int id, Solver &SS, LaneSolver *LS, PuzzleCanonizer *canon) {
+        uint32_t first = retired.load (std::memory_order_acquire);
+        for (int pass = 0; pass < 2; pass++)
+            for (int i = 0; i < window; i++) {
+                Chunk &c = chunks[(first + i) % window];
+                uint64_t v = c.claim.load (std::memory_order_acquire);
+                if (pass == 0 && (v >> 32) % threads != (uint64_t) id)
+                    continue;
+                while (true) {
+                    uint32_t count = (v >> 16) & 0xffff, next = v & 0xffff;
+                    if (next >= count)
+                        break;
+                    uint32_t n = count - next < grab ? count - next : grab;
+                    if (c.claim.compare_exchange_weak (v, v + n, std::memory_order_acquire)) {
+                        solveRange (c, next, n, SS, LS, canon, summaries[id]);
+                        return true;
+                    }
+                }
+            }
+        return false;
+    }
+
+    /*  This method solves the puzzles [first, first + n) of the chunk and
+     *  wakes the writer if they were the last ones. With a lane solver the
+     *  puzzles are solved in lockstep; solve statistics are only kept for
+     *  the scalar path.
+     */
+    void solveRange (Chunk &c, uint32_t first, uint32_t n, Solver &SS, LaneSolver *LS, PuzzleCanonizer *canon,
+                     StatsSummary &stats) {
+        (void) stats; // Only SUDOKU_STATS builds keep statistics.
+        if (LS != NULL)
+            solveLaneLines (*LS, c.line + first, c.length + first, n, c.out + first * (LINE + 1), LINE + 1,
+                            c.status + first, unique, c.conflict + first);
+        for (uint32_t k = first; k < first + n; k++) {
+            char *out = c.out + k * (LINE + 1);
+            if (LS == NULL) {
+                c.status[k] = (uint8_t) solveCachedLine (SS, canon, cache, c.line[k], c.length[k], out, unique);
+                c.conflict[k] = SS.conflict;
+                c.nodes[k] = c.status[k] != SOLVE_INVALID ? (uint32_t) SS.nodes : 0;
+                SUDOKU_STAT (if (c.status[k] != SOLVE_INVALID) stats.add (SS.stats));
+            }
+            else
+                c.nodes[k] = 0;
+            out[LINE] = '\n';
+        }
+        if (c.done.fetch_add (n, std::memory_order_acq_rel) + n == c.count) {
+            std::lock_guard<std::mutex> guard (lock);
+            chunkDone.notify_all ();
+        }
+    }
+
+};
+
+typedef BasicBatchPool<3> BatchPool;    // Pool of 9x9 solvers
+
+#endif
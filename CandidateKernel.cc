@@ -0,0 +1,267 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   CandidateKernel.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Candidate scan of a whole 9x9 board at once. Given the
+ *                  81 cells and the 27 unit tags of a board, the kernel
+ *                  works out the candidates of every empty cell, counts
+ *                  them and returns the first cell with the fewest
+ *                  candidates together with the set of naked singles.
+ *
+ *                  The AVX2 version looks at 32 cells per step and the
+ *                  SSE4.1 version at 16. Both keep the low and the high
+ *                  byte of the row, column and block tags in one register
+ *                  each and pick the tags of all the cells of a step with
+ *                  a byte shuffle. The candidate bits are counted with a
+ *                  nibble lookup shuffle and the smallest count is found
+ *                  with byte minimums. The scalar version does the same one
+ *                  cell at a time and is used on other CPUs.
+ *
+ *                  The version is picked once at startup from the CPU the
+ *                  program runs on. Setting SUDOKU_KERNEL to "scalar" or
+ *                  "sse4.1" forces a lower one, for testing and timing.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Notes       :   The kernels read the cells in blocks of 16 or 32 and the
+ *                  tags in blocks of 8, so the caller must have 96 bytes of
+ *                  cells and 32 tags readable. The solver's Board is laid
+ *                  out that way.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CANDIDATEKERNEL_CC
+#define CANDIDATEKERNEL_CC
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#if defined (__x86_64__) || defined (__i386__)
+#include <immintrin.h>
+#define CANDIDATE_KERNEL_X86
+#endif
+
+#define SCAN_CELLS      81      // Cells of a 9x9 board
+#define SCAN_PADDED     96      // Cells rounded up to whole 32 cell steps
+
+/*  Result of one candidate scan.
+ */
+struct CandidateScan {
+    int         best;           // First empty cell with the fewest candidates, -1 if all are filled
+    int         bestCount;      // Candidates of that cell, 0 if some empty cell has none
+    uint64_t    singles [2];    // Bit k set if empty cell k has exactly one candidate
+};
+
+typedef void (*CandidateKernel) (const uint8_t *cells, const uint16_t *tags, CandidateScan &scan);
+
+/*  Per cell tag numbers for the shuffles, padded to SCAN_PADDED cells. The
+ *  column and block numbers index the column and block tag registers, so
+ *  they run 0 to 8 like the rows do. 'valid' is 0xff for the real cells.
+ */
+struct CandidateTables {
+    uint8_t     row [SCAN_PADDED];
+    uint8_t     col [SCAN_PADDED];
+    uint8_t     blk [SCAN_PADDED];
+    uint8_t     valid [SCAN_PADDED];
+
+    constexpr CandidateTables (void) : row (), col (), blk (), valid () {
+        for (int k = 0; k < SCAN_CELLS; k++) {
+            row[k] = (uint8_t) (k / 9);
+            col[k] = (uint8_t) (k % 9);
+            blk[k] = (uint8_t) ((k / 27) * 3 + (k % 9) / 3);
+            valid[k] = 0xff;
+        }
+    }
+};
+
+alignas (32) static constexpr CandidateTables candidateTables = CandidateTables ();
+
+/*  This function is the portable version of the scan.
+ */
+inline void scanCandidatesScalar (const uint8_t *cells, const uint16_t *tags, CandidateScan &scan) {
+    const CandidateTables &t = candidateTables;
+    scan.best = -1;
+    scan.bestCount = 10;
+    scan.singles[0] = scan.singles[1] = 0;
+    for (int k = 0; k < SCAN_CELLS; k++) {
+        if (cells[k] > 0)
+            continue;
+        int count = __builtin_popcount (~(tags[t.row[k]] | tags[9 + t.col[k]] | tags[18 + t.blk[k]]) & 0x1ff);
+        if (count == 1)
+            scan.singles[k >> 6] |= 1ull << (k & 63);
+        if (count < scan.bestCount) {
+            scan.best = k;
+            scan.bestCount = count;
+        }
+    }
+    if (scan.best < 0)
+        scan.bestCount = 0;
+}
+
+#ifdef CANDIDATE_KERNEL_X86
+
+/*  This function splits the 27 tags into the low and the high bytes of the
+ *  row, column and block tags, one register each, so that byte n of a
+ *  register belongs to row, column or block n.
+ */
+__attribute__ ((target ("sse4.1")))
+inline void splitTags (const uint16_t *tags, __m128i split [6]) {
+    const __m128i even = _mm_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    __m128i a = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (tags + 0)), even);
+    __m128i b = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (tags + 8)), even);
+    __m128i c = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (tags + 16)), even);
+    __m128i d = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (tags + 24)), even);
+    __m128i lo = _mm_unpacklo_epi64 (a, b), hi = _mm_unpackhi_epi64 (a, b);    // Tags 0 to 15
+    __m128i lo2 = _mm_unpacklo_epi64 (c, d), hi2 = _mm_unpackhi_epi64 (c, d);  // Tags 16 to 31
+    split[0] = lo;
+    split[1] = hi;
+    split[2] = _mm_alignr_epi8 (lo2, lo, 9);
+    split[3] = _mm_alignr_epi8 (hi2, hi, 9);
+    split[4] = _mm_srli_si128 (lo2, 2);
+    split[5] = _mm_srli_si128 (hi2, 2);
+}
+
+/*  This function turns the per cell minimum counts into the result: the
+ *  smallest count and the first cell that has it.
+ */
+inline void finishScan (const uint8_t *counts, int min, CandidateScan &scan) {
+    if (min == 0xff) {
+        scan.best = -1;
+        scan.bestCount = 0;
+        return;
+    }
+    scan.bestCount = min;
+    scan.best = (int) ((const uint8_t *) memchr (counts, min, SCAN_PADDED) - counts);
+}
+
+__attribute__ ((target ("sse4.1")))
+inline void scanCandidatesSSE41 (const uint8_t *cells, const uint16_t *tags, CandidateScan &scan) {
+    const CandidateTables &t = candidateTables;
+    const __m128i nibbles = _mm_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low4 = _mm_set1_epi8 (0x0f), one = _mm_set1_epi8 (1), ones = _mm_set1_epi8 (-1);
+    alignas (16) uint8_t counts [SCAN_PADDED];
+    __m128i tag [6], least = ones;
+    uint32_t singles [SCAN_PADDED / 16];
+
+    splitTags (tags, tag);
+    for (int c = 0; c < SCAN_PADDED / 16; c++) {
+        int k = c * 16;
+        __m128i r = _mm_load_si128 ((const __m128i *) (t.row + k));
+        __m128i q = _mm_load_si128 ((const __m128i *) (t.col + k));
+        __m128i b = _mm_load_si128 ((const __m128i *) (t.blk + k));
+        __m128i lo = _mm_or_si128 (_mm_or_si128 (_mm_shuffle_epi8 (tag[0], r), _mm_shuffle_epi8 (tag[2], q)),
+                                   _mm_shuffle_epi8 (tag[4], b));
+        __m128i hi = _mm_or_si128 (_mm_or_si128 (_mm_shuffle_epi8 (tag[1], r), _mm_shuffle_epi8 (tag[3], q)),
+                                   _mm_shuffle_epi8 (tag[5], b));
+        __m128i empty = _mm_and_si128 (_mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) (cells + k)), _mm_setzero_si128 ()),
+                                       _mm_load_si128 ((const __m128i *) (t.valid + k)));
+        lo = _mm_andnot_si128 (lo, empty);
+        hi = _mm_andnot_si128 (hi, _mm_and_si128 (empty, one));
+        __m128i count = _mm_add_epi8 (_mm_add_epi8 (_mm_shuffle_epi8 (nibbles, _mm_and_si128 (lo, low4)),
+                                                    _mm_shuffle_epi8 (nibbles, _mm_and_si128 (_mm_srli_epi16 (lo, 4), low4))), hi);
+        count = _mm_or_si128 (count, _mm_andnot_si128 (empty, ones)); // Filled cells count as 0xff.
+        _mm_store_si128 ((__m128i *) (counts + k), count);
+        least = _mm_min_epu8 (least, count);
+        singles[c] = (uint32_t) _mm_movemask_epi8 (_mm_cmpeq_epi8 (count, one));
+    }
+    least = _mm_min_epu8 (least, _mm_srli_si128 (least, 8));
+    least = _mm_min_epu8 (least, _mm_srli_si128 (least, 4));
+    least = _mm_min_epu8 (least, _mm_srli_si128 (least, 2));
+    least = _mm_min_epu8 (least, _mm_srli_si128 (least, 1));
+    scan.singles[0] = singles[0] | (uint64_t) singles[1] << 16 | (uint64_t) singles[2] << 32 | (uint64_t) singles[3] << 48;
+    scan.singles[1] = singles[4] | (uint64_t) singles[5] << 16;
+    finishScan (counts, _mm_cvtsi128_si32 (least) & 0xff, scan);
+}
+
+__attribute__ ((target ("avx2")))
+inline void scanCandidatesAVX2 (const uint8_t *cells, const uint16_t *tags, CandidateScan &scan) {
+    const CandidateTables &t = candidateTables;
+    const __m256i nibbles = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                              0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8 (0x0f), one = _mm256_set1_epi8 (1), ones = _mm256_set1_epi8 (-1);
+    alignas (32) uint8_t counts [SCAN_PADDED];
+    __m128i split [6];
+    __m256i tag [6], least = ones;
+    uint32_t singles [SCAN_PADDED / 32];
+
+    splitTags (tags, split);
+    for (int n = 0; n < 6; n++)
+        tag[n] = _mm256_broadcastsi128_si256 (split[n]); // The shuffles stay inside 128 bit lanes.
+    for (int c = 0; c < SCAN_PADDED / 32; c++) {
+        int k = c * 32;
+        __m256i r = _mm256_load_si256 ((const __m256i *) (t.row + k));
+        __m256i q = _mm256_load_si256 ((const __m256i *) (t.col + k));
+        __m256i b = _mm256_load_si256 ((const __m256i *) (t.blk + k));
+        __m256i lo = _mm256_or_si256 (_mm256_or_si256 (_mm256_shuffle_epi8 (tag[0], r), _mm256_shuffle_epi8 (tag[2], q)),
+                                      _mm256_shuffle_epi8 (tag[4], b));
+        __m256i hi = _mm256_or_si256 (_mm256_or_si256 (_mm256_shuffle_epi8 (tag[1], r), _mm256_shuffle_epi8 (tag[3], q)),
+                                      _mm256_shuffle_epi8 (tag[5], b));
+        __m256i empty = _mm256_and_si256 (_mm256_cmpeq_epi8 (_mm256_loadu_si256 ((const __m256i *) (cells + k)), _mm256_setzero_si256 ()),
+                                          _mm256_load_si256 ((const __m256i *) (t.valid + k)));
+        lo = _mm256_andnot_si256 (lo, empty);
+        hi = _mm256_andnot_si256 (hi, _mm256_and_si256 (empty, one));
+        __m256i count = _mm256_add_epi8 (_mm256_add_epi8 (_mm256_shuffle_epi8 (nibbles, _mm256_and_si256 (lo, low4)),
+                                                          _mm256_shuffle_epi8 (nibbles, _mm256_and_si256 (_mm256_srli_epi16 (lo, 4), low4))), hi);
+        count = _mm256_or_si256 (count, _mm256_andnot_si256 (empty, ones)); // Filled cells count as 0xff.
+        _mm256_store_si256 ((__m256i *) (counts + k), count);
+        least = _mm256_min_epu8 (least, count);
+        singles[c] = (uint32_t) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (count, one));
+    }
+    __m128i m = _mm_min_epu8 (_mm256_castsi256_si128 (least), _mm256_extracti128_si256 (least, 1));
+    m = _mm_min_epu8 (m, _mm_srli_si128 (m, 8));
+    m = _mm_min_epu8 (m, _mm_srli_si128 (m, 4));
+    m = _mm_min_epu8 (m, _mm_srli_si128 (m, 2));
+    m = _mm_min_epu8 (m, _mm_srli_si128 (m, 1));
+    scan.singles[0] = singles[0] | (uint64_t) singles[1] << 32;
+    scan.singles[1] = singles[2];
+    finishScan (counts, _mm_cvtsi128_si32 (m) & 0xff, scan);
+}
+
+#endif
+
+/*  This function picks the best kernel the CPU supports, or the one named
+ *  by SUDOKU_KERNEL if that is supported too.
+ */
+inline CandidateKernel selectCandidateKernel (const char **name = NULL) {
+    const char *want = getenv ("SUDOKU_KERNEL");
+    const char *dummy;
+    if (name == NULL)
+        name = &dummy;
+#ifdef CANDIDATE_KERNEL_X86
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2") && (want == NULL || strcmp (want, "avx2") == 0)) {
+        *name = "avx2";
+        return scanCandidatesAVX2;
+    }
+    if (__builtin_cpu_supports ("sse4.1") && (want == NULL || strcmp (want, "scalar") != 0)) {
+        *name = "sse4.1";
+        return scanCandidatesSSE41;
+    }
+#endif
+    (void) want;
+    *name = "scalar";
+    return scanCandidatesScalar;
+}
+
+inline const CandidateKernel scanCandidates = selectCandidateKernel ();
+
+#endif
@@ -0,0 +1,518 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   ConflictSolver.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Conflict driven clause learning (CDCL) search for
+ *                  BasicSudokuSolver, the engine for the pathological
+ *                  puzzles on which the backtracker's tree explodes. The
+ *                  board is a SAT problem with one variable per (cell,
+ *                  value) pair: x(k, v) is true when cell k holds v + 1.
+ *
+ *                  The "at least one" constraints, a value per cell and a
+ *                  place per value and unit, are real clauses with two
+ *                  watched literals each. The "at most one" constraints are
+ *                  not stored: making x(k, v) true clears the other values
+ *                  of cell k and the value v of the peers of k straight
+ *                  from the geometry tables, which is what the tags do in
+ *                  the backtracker. A conflict is analysed back to its
+ *                  first unique implication point, the learnt clause is
+ *                  added and the search jumps back to the level it becomes
+ *                  unit at. Variables in conflicts gain activity and the
+ *                  decisions take the most active one. The search restarts
+ *                  on the Luby sequence and forgets its learnt clauses when
+ *                  they outgrow LEARNT_LITERALS.
+ *
+ *                  The clause, literal and watch vectors are used as
+ *                  arenas: a solve truncates them and never gives their
+ *                  memory back, so once they have grown to what a corpus
+ *                  needs, solving allocates nothing.
+ *
+ *                  Solutions are counted by adding a clause that rules out
+ *                  the decisions of each solution found, so the search goes
+ *                  on until 'limit' are found or the problem is unsatisfiable.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Notes       :   The class is a template on the geometry (SudokuGeometry<B>)
+ *                  rather than on B so it can be included ahead of it.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CONFLICTSOLVER_CC
+#define CONFLICTSOLVER_CC
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+#include "SolveLimits.cc"    // Node, time and cancel limits.
+
+#define RESTART_CONFLICTS   64      // Conflicts per unit of the Luby restart sequence
+#define NO_CONFLICT         -1      // propagate(): fixed point reached
+#define PAIR_CONFLICT       -2      // propagate(): two true variables exclude each other
+
+template <class Geometry>
+class BasicConflictSolver {
+
+    public:
+
+        static constexpr int NUM = Geometry::NUM;
+        static constexpr int CELLS = Geometry::CELLS;
+        static constexpr int UNITS = Geometry::UNITS;
+        static constexpr int PEERS = Geometry::PEERS;
+        static constexpr int VARS = CELLS * NUM;        // x(k, v) is variable k * NUM + v
+        static constexpr int LITS = 2 * VARS;           // 2x is x, 2x + 1 is not x
+        static constexpr int LEARNT_LITERALS = 64 * VARS;   // Learnt clause literals kept at most
+
+        static constexpr Geometry geo = Geometry ();
+
+        /*  A clause is 'size' literals of 'lits' starting at 'start'. The
+         *  first two are the watched ones.
+         */
+        struct Clause {
+            int         start;
+            int         size;
+            bool        learnt;             // Learnt from a conflict, may be dropped
+        };
+
+        std::vector<Clause> clauses;        // Constraint clauses first, then the added ones
+        std::vector<int> lits;              // Literals of all the clauses
+        std::vector<int> watches [LITS];    // Clauses watching each literal
+        std::vector<int> learntClause;      // Scratch for analyze ()
+        std::vector<int> staticLits;        // Literals of the constraint clauses as built
+        int             staticClauses;      // Clauses of the constraints
+        int             learntLits;         // Literals of the learnt clauses
+        int8_t          value [VARS];       // -1 unassigned, else 0 or 1
+        int             level [VARS];       // Decision level of each assignment
+        int             reason [VARS];      // Implying clause, -1 for decisions and givens,
+                                            // -2 - x when true variable x excluded it
+        double          activity [VARS];    // Decision priority
+        double          bump;               // Current activity increment
+        uint8_t         seen [VARS];        // Marks of analyze ()
+        int             trail [VARS];       // Literals made true, in order
+        int             trailLen;
+        int             qhead;              // Trail entries propagated so far
+        int             trailLim [VARS + 1];    // Trail length at the start of each level
+        int             decisionLevel;
+        int             pair [2];           // The two variables of a PAIR_CONFLICT
+        long            conflicts;          // Conflicts of the last solve
+        long            restarts;           // Restarts of the last solve
+
+    BasicConflictSolver (void) {
+        int c [NUM];
+        for (int k = 0; k < CELLS; k++) { // Every cell holds a value.
+            for (int v = 0; v < NUM; v++)
+                c[v] = 2 * (k * NUM + v);
+            addClause (c, NUM, false);
+        }
+        for (int u = 0; u < UNITS; u++) // Every value has a place in every unit.
+            for (int v = 0; v < NUM; v++) {
+                for (int n = 0; n < NUM; n++)
+                    c[n] = 2 * (geo.unitCells[u][n] * NUM + v);
+                addClause (c, NUM, false);
+            }
+        staticClauses = (int) clauses.size ();
+        staticLits = lits;
+        lits.reserve (lits.size () + LEARNT_LITERALS);
+        learntClause.reserve (VARS + 1); // A clause has at most one literal per level.
+        learntLits = 0;
+        conflicts = 0;
+        restarts = 0;
+    }
+
+    /*  This method counts the solutions of the board 'cells' (0 for an
+     *  empty cell) up to 'limit' and copies the first one to 'solution'.
+     *  'nodes' goes up by one per decision. When the budget runs out it
+     *  stops with the solutions found so far.
+     */
+    int solve (const uint8_t *cells, int limit, uint8_t *solution, long &nodes, SolveBudget &budget) {
+        int found = 0, empty = 0;
+        long nextRestart = RESTART_CONFLICTS;
+
+        for (int k = 0; k < CELLS; k++)
+            empty += cells[k] == 0;
+        if (empty == 0) { // Nothing to search, skip setting up the clauses.
+            for (int k = 0; k < CELLS; k++)
+                solution[k] = cells[k];
+            return 1;
+        }
+        reset ();
+        for (int k = 0; k < CELLS; k++) {
+            if (cells[k] == 0)
+                continue;
+            int x = k * NUM + cells[k] - 1;
+            if (value[x] == 0)
+                return 0;
+            if (value[x] < 0)
+                enqueue (2 * x, -1);
+        }
+        if (propagate () != NO_CONFLICT)
+            return 0;
+        for (int k = 0; k < CELLS; k++) // Cells with few candidates are tried first.
+            for (int v = 0; v < NUM; v++)
+                activity[k * NUM + v] = cells[k] ? 0 : 1e-3 / (1 + countOpen (k));
+
+        while (true) {
+            int confl = propagate ();
+            if (confl != NO_CONFLICT) {
+                conflicts++;
+                if (decisionLevel == 0)
+                    break;
+                int back = analyze (confl);
+                backtrack (back);
+                learn ();
+                bump *= 1 / 0.95;
+                continue;
+            }
+            if (conflicts >= nextRestart) {
+                backtrack (0);
+                restarts++;
+                nextRestart = conflicts + RESTART_CONFLICTS * luby (restarts);
+                if (learntLits > LEARNT_LITERALS)
+                    dropLearnt ();
+                continue;
+            }
+            int x = pickBranch ();
+            if (x < 0) { // Every variable is assigned: a solution.
+                if (found++ == 0)
+                    saveSolution (solution);
+                if (found == limit || !blockSolution ())
+                    break;
+                continue;
+            }
+            if (budget.spent (++nodes))
+                break;
+            trailLim[decisionLevel++] = trailLen;
+            enqueue (2 * x, -1);
+        }
+        return found;
+    }
+
+    /*  This method clears the assignment and the clauses added by the last
+     *  solve, and watches the constraint clauses afresh in the order they
+     *  were built, so a solve does not depend on the ones before it.
+     */
+    void reset (void) {
+        clauses.resize (staticClauses);
+        lits.resize (staticLits.size ());
+        std::copy (staticLits.begin (), staticLits.end (), lits.begin ());
+        learntLits = 0;
+        rebuildWatches ();
+        for (int x = 0; x < VARS; x++) {
+            value[x] = -1;
+            seen[x] = 0;
+        }
+        trailLen = qhead = decisionLevel = 0;
+        bump = 1;
+        conflicts = restarts = 0;
+    }
+
+    /*  This method stores a clause. Added clauses are watched on their
+     *  first two literals, which the caller has put in order.
+     */
+    int addClause (const int *c, int size, bool learnt) {
+        Clause cl = { (int) lits.size (), size, learnt };
+        lits.insert (lits.end (), c, c + size);
+        clauses.push_back (cl);
+        if (learnt)
+            learntLits += cl.size;
+        if (cl.size > 1) {
+            watches[c[0]].push_back ((int) clauses.size () - 1);
+            watches[c[1]].push_back ((int) clauses.size () - 1);
+        }
+        return (int) clauses.size () - 1;
+    }
+
+    void rebuildWatches (void) {
+        for (int l = 0; l < LITS; l++)
+            watches[l].clear ();
+        for (int c = 0; c < (int) clauses.size (); c++)
+            if (clauses[c].size > 1) {
+                watches[lits[clauses[c].start]].push_back (c);
+                watches[lits[clauses[c].start + 1]].push_back (c);
+            }
+    }
+
+    /*  This method returns 1 if literal l is true, 0 if false and -1 if its
+     *  variable is unassigned.
+     */
+    int litValue (int l) {
+        int v = value[l >> 1];
+        return v < 0 ? -1 : v ^ (l & 1);
+    }
+
+    void enqueue (int l, int why) {
+        int x = l >> 1;
+        value[x] = (int8_t) ((l & 1) ^ 1);
+        level[x] = decisionLevel;
+        reason[x] = why;
+        trail[trailLen++] = l;
+    }
+
+    /*  This method makes variable y false because x is true. It returns
+     *  false if y is already true.
+     */
+    bool exclude (int y, int x) {
+        if (value[y] == 1) {
+            pair[0] = x;
+            pair[1] = y;
+            return false;
+        }
+        if (value[y] < 0)
+            enqueue (2 * y + 1, -2 - x);
+        return true;
+    }
+
+    /*  This method runs unit propagation over the trail. It returns
+     *  NO_CONFLICT, PAIR_CONFLICT or the clause that has every literal
+     *  false.
+     */
+    int propagate (void) {
+        while (qhead < trailLen) {
+            int p = trail[qhead++];
+            if ((p & 1) == 0) { // Variable made true: the at most one constraints.
+                int x = p >> 1, k = x / NUM, v = x % NUM;
+                for (int w = 0; w < NUM; w++)
+                    if (w != v && !exclude (k * NUM + w, x))
+                        return PAIR_CONFLICT;
+                for (int n = 0; n < PEERS; n++)
+                    if (!exclude (geo.peers[k][n] * NUM + v, x))
+                        return PAIR_CONFLICT;
+            }
+
+            int f = p ^ 1; // Now false, its clauses need another watch.
+            std::vector<int> &ws = watches[f];
+            size_t i = 0, j = 0;
+            while (i < ws.size ()) {
+                int c = ws[i++];
+                int *L = &lits[clauses[c].start];
+                if (L[0] == f) {
+                    L[0] = L[1];
+                    L[1] = f;
+                }
+                if (litValue (L[0]) == 1) {
+                    ws[j++] = c;
+                    continue;
+                }
+                bool moved = false;
+                for (int n = 2; n < clauses[c].size && !moved; n++)
+                    if (litValue (L[n]) != 0) {
+                        L[1] = L[n];
+                        L[n] = f;
+                        watches[L[1]].push_back (c);
+                        moved = true;
+                    }
+                if (moved)
+                    continue;
+                ws[j++] = c;
+                if (litValue (L[0]) == 0) {
+                    while (i < ws.size ())
+                        ws[j++] = ws[i++];
+                    ws.resize (j);
+                    return c;
+                }
+                enqueue (L[0], c);
+            }
+            ws.resize (j);
+        }
+        return NO_CONFLICT;
+    }
+
+    /*  This method derives the first UIP clause of a conflict into
+     *  learntClause, asserting literal first, and returns the level to
+     *  jump back to.
+     */
+    int analyze (int confl) {
+        int pathCount = 0, p = -1, idx = trailLen - 1;
+        int two [2] = { 2 * pair[0] + 1, 2 * pair[1] + 1 };
+        const int *L = two;
+        int size = 2;
+
+        learntClause.assign (1, -1);
+        while (true) {
+            if (confl >= 0) {
+                L = &lits[clauses[confl].start];
+                size = clauses[confl].size;
+            }
+            for (int n = 0; n < size; n++) {
+                int x = L[n] >> 1;
+                if (p >= 0 && x == (p >> 1))
+                    continue;
+                if (seen[x] || level[x] == 0)
+                    continue;
+                seen[x] = 1;
+                bumpActivity (x);
+                if (level[x] == decisionLevel)
+                    pathCount++;
+                else
+                    learntClause.push_back (L[n]);
+            }
+            while (!seen[trail[idx] >> 1])
+                idx--;
+            p = trail[idx--];
+            seen[p >> 1] = 0;
+            if (--pathCount == 0)
+                break;
+            confl = reason[p >> 1];
+            if (confl < 0) { // Excluded by a true variable.
+                two[0] = 2 * (-2 - confl) + 1;
+                two[1] = p;
+                L = two;
+                size = 2;
+            }
+        }
+        learntClause[0] = p ^ 1;
+
+        int back = 0;
+        for (size_t n = 1; n < learntClause.size (); n++) {
+            int x = learntClause[n] >> 1;
+            seen[x] = 0;
+            if (level[x] > back) {
+                back = level[x];
+                int t = learntClause[1];
+                learntClause[1] = learntClause[n];
+                learntClause[n] = t;
+            }
+        }
+        return back;
+    }
+
+    /*  This method adds learntClause after the jump back and makes its
+     *  first literal true.
+     */
+    void learn (void) {
+        if (learntClause.size () == 1)
+            enqueue (learntClause[0], -1);
+        else
+            enqueue (learntClause[0], addClause (learntClause.data (), (int) learntClause.size (), true));
+    }
+
+    /*  This method takes back every assignment above level 'to'.
+     */
+    void backtrack (int to) {
+        if (decisionLevel <= to)
+            return;
+        for (int n = trailLen - 1; n >= trailLim[to]; n--)
+            value[trail[n] >> 1] = -1;
+        trailLen = qhead = trailLim[to];
+        decisionLevel = to;
+    }
+
+    /*  This method adds the clause that rules out the decisions of the
+     *  solution just found and jumps back to make it unit. It returns false
+     *  if the solution needed no decision, then there is no other.
+     */
+    bool blockSolution (void) {
+        if (decisionLevel == 0)
+            return false;
+        learntClause.clear ();
+        for (int l = decisionLevel; l > 0; l--)
+            learntClause.push_back (trail[trailLim[l - 1]] ^ 1);
+        backtrack (decisionLevel - 1);
+        if (learntClause.size () == 1)
+            enqueue (learntClause[0], -1);
+        else
+            enqueue (learntClause[0], addClause (learntClause.data (), (int) learntClause.size (), false));
+        return true;
+    }
+
+    /*  This method forgets the learnt clauses. It runs at level 0, where
+     *  no assignment has a learnt clause as its reason that analyze ()
+     *  would look at, and propagates the trail again over the new watches.
+     *  The clauses that stay are moved down in place.
+     */
+    void dropLearnt (void) {
+        size_t kept = staticClauses;
+        int end = clauses[staticClauses - 1].start + clauses[staticClauses - 1].size;
+        for (size_t c = staticClauses; c < clauses.size (); c++)
+            if (!clauses[c].learnt) {
+                Clause cl = { end, clauses[c].size, false };
+                std::copy (lits.begin () + clauses[c].start, lits.begin () + clauses[c].start + cl.size,
+                           lits.begin () + end);
+                clauses[kept++] = cl;
+                end += cl.size;
+            }
+        clauses.resize (kept);
+        lits.resize (end);
+        learntLits = 0;
+        rebuildWatches ();
+        for (int n = 0; n < trailLen; n++)
+            reason[trail[n] >> 1] = -1;
+        qhead = 0;
+    }
+
+    void bumpActivity (int x) {
+        activity[x] += bump;
+        if (activity[x] > 1e100) {
+            for (int y = 0; y < VARS; y++)
+                activity[y] *= 1e-100;
+            bump *= 1e-100;
+        }
+    }
+
+    /*  This method returns the unassigned variable of highest activity, or
+     *  -1 if every variable is assigned.
+     */
+    int pickBranch (void) {
+        int best = -1;
+        for (int x = 0; x < VARS; x++)
+            if (value[x] < 0 && (best < 0 || activity[x] > activity[best]))
+                best = x;
+        return best;
+    }
+
+    /*  This method counts the values of cell k that are still open.
+     */
+    int countOpen (int k) {
+        int n = 0;
+        for (int v = 0; v < NUM; v++)
+            n += value[k * NUM + v] < 0;
+        return n;
+    }
+
+    void saveSolution (uint8_t *solution) {
+        for (int x = 0; x < VARS; x++)
+            if (value[x] == 1)
+                solution[x / NUM] = (uint8_t) (x % NUM + 1);
+    }
+
+    /*  This function returns the i-th (from 1) term of the Luby sequence
+     *  1 1 2 1 1 2 4 1 1 2 ...
+     */
+    static long luby (long i) {
+        long size = 1;
+        int seq = 0;
+        while (size < i + 1) {
+            size = 2 * size + 1;
+            seq++;
+        }
+        long x = i;
+        while (size - 1 != x) {
+            size = (size - 1) >> 1;
+            seq--;
+            x = x % size;
+        }
+        return 1L << seq;
+    }
+
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   DancingLinks.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Exact cover search (Knuth's Algorithm X with dancing
+ *                  links) for BasicSudokuSolver, as the alternative to the
+ *                  tag based backtracker. A board of N x N cells is the
+ *                  exact cover problem with one row per (cell, value) pair
+ *                  and 4 * N * N columns: every cell holds one value and
+ *                  every row, column and block holds every value once.
+ *                  The search always covers the column with the fewest
+ *                  rows left, which keeps adversarial grids from blowing
+ *                  up the tree.
+ *
+ *                  All the nodes live in fixed arrays that are linked up
+ *                  once, when the object is made. A solve covers the givens
+ *                  and searches; every cover is recorded on a stack and
+ *                  undone in reverse order at the end, so the links are
+ *                  back in their starting state for the next puzzle and
+ *                  nothing is freed or allocated. The search is iterative
+ *                  and counts solutions up to a limit.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef DANCINGLINKS_CC
+#define DANCINGLINKS_CC
+
+#include <stdint.h>
+#include "SolveLimits.cc"    // Node, time and cancel limits.
+
+template <int B>
+class BasicDancingLinks {
+
+    public:
+
+        static constexpr int NUM = B * B;               // Values, and cells per unit
+        static constexpr int CELLS = NUM * NUM;         // Cells of the board
+        static constexpr int ROWS = CELLS * NUM;        // (cell, value) pairs
+        static constexpr int COLUMNS = 4 * CELLS;       // Constraints
+        static constexpr int NODES = 1 + COLUMNS + 4 * ROWS;    // Root, column headers, row nodes
+
+        /*  One level of the search: the column being covered, the row
+         *  tried for it and the cover stack height after the column.
+         */
+        struct Frame {
+            int         col;
+            int         row;
+            int         mark;
+        };
+
+        int         left [NODES];           // Links of the nodes. Node 0 is the root,
+        int         right [NODES];          // 1 to COLUMNS are the column headers.
+        int         up [NODES];
+        int         down [NODES];
+        int         column [NODES];         // Column header of each node
+        int         size [COLUMNS + 1];     // Rows left in each column
+        int         covered [COLUMNS];      // Columns covered so far, in order
+        int         coveredLen;             // Entries in covered
+        Frame       stack [CELLS];          // Open levels of the search
+
+    BasicDancingLinks (void) {
+        for (int c = 0; c <= COLUMNS; c++) {
+            left[c] = c == 0 ? COLUMNS : c - 1;
+            right[c] = c == COLUMNS ? 0 : c + 1;
+            up[c] = down[c] = column[c] = c;
+            size[c] = 0;
+        }
+        for (int r = 0; r < ROWS; r++) {
+            int k = r / NUM, v = r % NUM, i = k / NUM, j = k % NUM, b = (i / B) * B + j / B;
+            int cols [4] = { 1 + k, 1 + CELLS + i * NUM + v, 1 + 2 * CELLS + j * NUM + v, 1 + 3 * CELLS + b * NUM + v };
+            int first = rowNode (r);
+            for (int n = 0; n < 4; n++) {
+                int x = first + n, c = cols[n];
+                left[x] = n == 0 ? first + 3 : x - 1;
+                right[x] = n == 3 ? first : x + 1;
+                column[x] = c;
+                up[x] = up[c];      // Append at the bottom of the column.
+                down[x] = c;
+                down[up[c]] = x;
+                up[c] = x;
+                size[c]++;
+            }
+        }
+        coveredLen = 0;
+    }
+
+    /*  This method counts the solutions of the board 'cells' (0 for an
+     *  empty cell, the givens must not clash) up to 'limit' and copies the
+     *  first one to 'solution'. 'nodes' goes up by one per row tried. When
+     *  the budget runs out it stops with the solutions found so far.
+     */
+    int solve (const uint8_t *cells, int limit, uint8_t *solution, long &nodes, SolveBudget &budget) {
+        int level = 0, found = 0, empty = 0;
+        bool descend = true;
+
+        for (int k = 0; k < CELLS; k++)
+            empty += cells[k] == 0;
+        if (empty == 0) { // Nothing to search, skip building the cover.
+            saveSolution (cells, 0, solution);
+            return 1;
+        }
+        for (int k = 0; k < CELLS; k++) // Take the givens out of the matrix.
+            if (cells[k] > 0)
+                coverRow (rowNode (k * NUM + cells[k] - 1));
+
+        while (true) {
+            if (descend) {
+                if (right[0] == 0) { // Every constraint is met.
+                    if (found++ == 0)
+                        saveSolution (cells, level, solution);
+                    if (found == limit)
+                        break;
+                    descend = false;
+                    continue;
+                }
+                int c = chooseColumn ();
+                if (size[c] == 0) {
+                    descend = false;
+                    continue;
+                }
+                cover (c);
+                stack[level] = { c, down[c], coveredLen };
+            }
+            else {
+                if (level == 0)
+                    break;
+                Frame &f = stack[--level];
+                undoTo (f.mark); // Take back the row tried last.
+                f.row = down[f.row];
+            }
+
+            Frame &f = stack[level];
+            if (f.row == f.col) { // No row left for this column.
+                undoTo (f.mark - 1);
+                descend = false;
+                continue;
+            }
+            if (budget.spent (++nodes))
+                break;
+            for (int x = right[f.row]; x != f.row; x = right[x])
+                cover (column[x]);
+            level++;
+            descend = true;
+        }
+        undoTo (0);
+        return found;
+    }
+
+    /*  This function returns the first node of row r.
+     */
+    static int rowNode (int r) {
+        return 1 + COLUMNS + 4 * r;
+    }
+
+    /*  This method covers every column of the row that node x is in.
+     */
+    void coverRow (int x) {
+        int y = x;
+        do {
+            cover (column[y]);
+            y = right[y];
+        } while (y != x);
+    }
+
+    /*  This method returns the uncovered column with the fewest rows.
+     */
+    int chooseColumn (void) {
+        int best = right[0], least = size[best];
+        for (int c = right[best]; c != 0 && least > 1; c = right[c])
+            if (size[c] < least) {
+                best = c;
+                least = size[c];
+            }
+        return best;
+    }
+
+    /*  These methods take column c and every row through it out of the
+     *  matrix, and put them back. The links of the removed nodes are left
+     *  alone, that is what lets uncover undo a cover exactly.
+     */
+    void cover (int c) {
+        right[left[c]] = right[c];
+        left[right[c]] = left[c];
+        for (int i = down[c]; i != c; i = down[i])
+            for (int j = right[i]; j != i; j = right[j]) {
+                down[up[j]] = down[j];
+                up[down[j]] = up[j];
+                size[column[j]]--;
+            }
+        covered[coveredLen++] = c;
+    }
+
+    void uncover (int c) {
+        for (int i = up[c]; i != c; i = up[i])
+            for (int j = left[i]; j != i; j = left[j]) {
+                size[column[j]]++;
+                down[up[j]] = j;
+                up[down[j]] = j;
+            }
+        right[left[c]] = c;
+        left[right[c]] = c;
+    }
+
+    /*  This method uncovers columns in reverse order until only 'mark' of
+     *  them are covered.
+     */
+    void undoTo (int mark) {
+        while (coveredLen > mark)
+            uncover (covered[--coveredLen]);
+    }
+
+    /*  This method writes the givens and the rows chosen on the first
+     *  'level' levels of the search to 'solution'.
+     */
+    void saveSolution (const uint8_t *cells, int level, uint8_t *solution) {
+        for (int k = 0; k < CELLS; k++)
+            solution[k] = cells[k];
+        for (int l = 0; l < level; l++) {
+            int r = (stack[l].row - 1 - COLUMNS) / 4;
+            solution[r / NUM] = (uint8_t) (r % NUM + 1);
+        }
+    }
+
+};
+
+#endif
@@ -0,0 +1,284 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   LaneSolver.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Solves up to LANES independent 9x9 puzzles in lockstep,
+ *                  one puzzle per vector lane. Each cell keeps a vector of
+ *                  LANES candidate masks, so every mask operation works on
+ *                  all the puzzles at once. The logical stage runs lane
+ *                  parallel: per unit, the values of the solved cells are
+ *                  removed from the other cells (naked singles) and a value
+ *                  that fits only one cell is put there (hidden singles),
+ *                  until no lane changes any more.
+ *
+ *                  Most puzzles of a typical corpus are solved right there.
+ *                  The lanes that are left with open cells drop out to the
+ *                  scalar SudokuSolver, which solves them from the givens
+ *                  with the full search.
+ *
+ *                  The vectors use the GCC vector extensions. The
+ *                  propagation loop is built twice, for the base target
+ *                  and for AVX2, and the AVX2 one is used when the CPU
+ *                  has it (and SUDOKU_KERNEL does not ask for less, see
+ *                  CandidateKernel.cc).
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef LANESOLVER_CC
+#define LANESOLVER_CC
+
+#include <cstring>
+#include <stdint.h>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+#include "PuzzleIO.cc"      // One-line-per-puzzle format.
+
+#define LANES   16          // Puzzles solved in lockstep
+
+class LaneSolver {
+
+    public:
+
+        typedef uint16_t Lanes __attribute__ ((vector_size (2 * LANES)));
+
+        static constexpr int NUM = SudokuSolver::NUM;
+        static constexpr int CELLS = SudokuSolver::CELLS;
+        static constexpr int UNITS = SudokuSolver::UNITS;
+
+        Lanes           cand [CELLS];       // Candidates of each cell, bit n-1 for the value n
+        Lanes           invalid;            // Lanes whose givens clash
+        Lanes           dead;               // Lanes found to have no solution
+        SudokuSolver    scalar;             // Finishes the lanes logic cannot
+        long            logicalLanes;       // Puzzles solved lane parallel
+        long            searchLanes;        // Puzzles passed on to the scalar solver
+        bool            wide;               // Run the AVX2 build of the propagation
+
+    LaneSolver (void) {
+        const char *kernel;
+        selectCandidateKernel (&kernel);
+        wide = strcmp (kernel, "avx2") == 0;
+        logicalLanes = 0;
+        searchLanes = 0;
+    }
+
+    /*  This method solves the n (at most LANES) puzzles of 'in' and writes
+     *  the solutions to 'out' and the solve () status of each puzzle to
+     *  'status'. 'in' and 'out' may be the same arrays, and an output grid
+     *  is only written when its status is SOLVE_OK. A puzzle solved by the
+     *  lane parallel logic has a unique solution, so 'unique' only matters
+     *  for the puzzles that reach the scalar solver. If 'conflict' is given
+     *  it gets the solver's SolveConflict of each failed puzzle.
+     */
+    void solve (const SudokuSolver::Grid *in, SudokuSolver::Grid *out, int *status, int n, bool unique = false,
+                SolveConflict *conflict = NULL) {
+        if (n <= 0)
+            return;
+        for (int l = 0; l < LANES; l++) // Spare lanes repeat the first puzzle.
+            loadLane (l, in[l < n ? l : 0]);
+        checkGivens ();
+        propagate ();
+
+        for (int l = 0; l < n; l++) {
+            if (invalid[l] || dead[l]) {
+                status[l] = invalid[l] ? SOLVE_INVALID : SOLVE_UNSOLVABLE;
+                if (conflict != NULL)
+                    explain (in[l], conflict[l]);
+                continue;
+            }
+            if (laneSolved (l)) {
+                for (int k = 0; k < CELLS; k++)
+                    out[l][k / NUM][k % NUM] = __builtin_ctz (cand[k][l]) + 1;
+                status[l] = SOLVE_OK;
+                logicalLanes++;
+                if (conflict != NULL)
+                    conflict[l] = SolveConflict { -1, -1, -1, 0 };
+            }
+            else {
+                status[l] = scalar.solve (in[l], out[l], unique);
+                searchLanes++;
+                if (conflict != NULL)
+                    conflict[l] = scalar.conflict;
+            }
+        }
+    }
+
+    /*  This method finds where a puzzle that failed in its lane goes wrong,
+     *  by loading it on the scalar solver and running its logical stage.
+     *  Only failing puzzles pay for this.
+     */
+    void explain (const SudokuSolver::Grid &grid, SolveConflict &conflict) {
+        if (scalar.loadPuzzle (grid) && !scalar.solveLogical ())
+            scalar.findDeadEnd ();
+        conflict = scalar.conflict;
+    }
+
+    /*  This method puts the givens of one puzzle in lane l. Values outside
+     *  1..NUM are empty cells, which start with every candidate.
+     */
+    void loadLane (int l, const SudokuSolver::Grid &grid) {
+        for (int k = 0; k < CELLS; k++) {
+            int v = grid[k / NUM][k % NUM];
+            cand[k][l] = (v >= 1 && v <= NUM) ? (uint16_t) (1 << (v - 1)) : SudokuSolver::tagFull;
+        }
+    }
+
+    /*  This method marks the lanes in which two givens share a unit. Before
+     *  any propagation the givens are the only cells with one candidate.
+     */
+    void checkGivens (void) {
+        invalid = Lanes {};
+        for (int u = 0; u < UNITS; u++) {
+            const uint8_t *cells = SudokuSolver::geo.unitCells[u];
+            Lanes fixed = {}, clash = {};
+            for (int k = 0; k < NUM; k++) {
+                Lanes c = cand[cells[k]];
+                Lanes s = c & (Lanes) ((c & (c - 1)) == 0);
+                clash |= fixed & s;
+                fixed |= s;
+            }
+            invalid |= (Lanes) (clash != 0);
+        }
+        dead = invalid;
+    }
+
+    void propagate (void) {
+#ifdef CANDIDATE_KERNEL_X86
+        if (wide) {
+            propagateAVX2 ();
+            return;
+        }
+#endif
+        propagateLanes ();
+    }
+
+#ifdef CANDIDATE_KERNEL_X86
+    __attribute__ ((target ("avx2")))
+    void propagateAVX2 (void) {
+        propagateLanes ();
+    }
+#endif
+
+    /*  This method runs the lane parallel singles until nothing changes.
+     *  For every unit it collects the solved values ('fixed'), the values
+     *  that fit at least one cell ('once') and those that fit two or more
+     *  ('twice'). The other cells of the unit lose the fixed values, and a
+     *  cell that holds a value with no other place in the unit is reduced
+     *  to it. A lane dies when a unit has the same value solved twice, a
+     *  value with no place, or a cell with no candidate. The masks only
+     *  ever lose bits, so the loop ends.
+     */
+    __attribute__ ((always_inline))
+    void propagateLanes (void) {
+        const Lanes full = Lanes {} + SudokuSolver::tagFull;
+        while (true) {
+            Lanes changed = {};
+            for (int u = 0; u < UNITS; u++) {
+                const uint8_t *cells = SudokuSolver::geo.unitCells[u];
+                Lanes once = {}, twice = {}, fixed = {}, clash = {};
+                for (int k = 0; k < NUM; k++) {
+                    Lanes c = cand[cells[k]];
+                    Lanes s = c & (Lanes) ((c & (c - 1)) == 0);
+                    clash |= fixed & s;
+                    fixed |= s;
+                    twice |= once & c;
+                    once |= c;
+                }
+                dead |= (Lanes) (clash != 0) | (Lanes) (once != full);
+                Lanes hidden = once & ~twice & ~fixed;
+                for (int k = 0; k < NUM; k++) {
+                    Lanes c = cand[cells[k]];
+                    Lanes single = (Lanes) ((c & (c - 1)) == 0);
+                    Lanes h = c & hidden;
+                    Lanes hasHidden = (Lanes) (h != 0);
+                    Lanes next = (single & c) | (~single & ((hasHidden & h) | (~hasHidden & c & ~fixed)));
+                    changed |= next ^ c;
+                    cand[cells[k]] = next;
+                }
+            }
+            if (!anySet (changed & ~dead))
+                break;
+        }
+        for (int k = 0; k < CELLS; k++)
+            dead |= (Lanes) (cand[k] == 0);
+    }
+
+    /*  This method checks that every cell of lane l holds a single value.
+     */
+    bool laneSolved (int l) {
+        for (int k = 0; k < CELLS; k++)
+            if (cand[k][l] & (cand[k][l] - 1))
+                return false;
+        return true;
+    }
+
+    static bool anySet (const Lanes &v) {
+        uint64_t w [sizeof (Lanes) / 8];
+        uint64_t any = 0;
+        memcpy (w, &v, sizeof (w));
+        for (size_t n = 0; n < sizeof (Lanes) / 8; n++)
+            any |= w[n];
+        return any != 0;
+    }
+
+};
+
+/*  This function solves n (at most LANES) puzzle lines on the lane solver
+ *  and writes each result line to out + k * stride, like solvePuzzleLine
+ *  does for one line. Lines that cannot be parsed fail as SOLVE_INVALID
+ *  and do not take a lane.
+ */
+inline void solveLaneLines (LaneSolver &LS, const char *const *line, const uint16_t *len, int n,
+                            char *out, size_t stride, uint8_t *status, bool unique = false,
+                            SolveConflict *conflict = NULL) {
+    SudokuSolver::Grid grid [LANES];
+    SolveConflict where [LANES];
+    int result [LANES], lane [LANES], m = 0;
+
+    for (int k = 0; k < n; k++) {
+        if (conflict != NULL)
+            conflict[k] = SolveConflict { -1, -1, -1, 0 };
+        if (parsePuzzleLine (line[k], len[k], grid[m]))
+            lane[m++] = k;
+        else
+            status[k] = SOLVE_INVALID;
+    }
+    if (m == 0) { // Nothing to solve, every line goes back as it was read.
+        for (int k = 0; k < n; k++)
+            echoPuzzleLine<SudokuSolver::NUM> (line[k], len[k], out + k * stride);
+        return;
+    }
+    LS.solve (grid, grid, result, m, unique, conflict != NULL ? where : NULL);
+    for (int l = 0; l < m; l++) {
+        int k = lane[l];
+        status[k] = (uint8_t) result[l];
+        if (conflict != NULL)
+            conflict[k] = where[l];
+        if (result[l] == SOLVE_OK)
+            formatPuzzleLine (grid[l], out + k * stride);
+    }
+    for (int k = 0; k < n; k++)
+        if (status[k] != SOLVE_OK)
+            echoPuzzleLine<SudokuSolver::NUM> (line[k], len[k], out + k * stride);
+}
+
+#endif
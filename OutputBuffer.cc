@@ -0,0 +1,116 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   OutputBuffer.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Output stage of the batch mode. Results are formatted
+ *                  straight into one large buffer, and the buffer goes to
+ *                  the file descriptor with a single write () when it is
+ *                  full and at the end, never per line or per puzzle. The
+ *                  batch pool fills it from the writer thread only, one
+ *                  chunk at a time.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OUTPUTBUFFER_CC
+#define OUTPUTBUFFER_CC
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#define OUTPUT_BLOCK    (1 << 20)   // Bytes collected per write ()
+
+class OutputBuffer {
+
+    public:
+
+        int      fd;            // Output file descriptor
+        char    *buf;           // OUTPUT_BLOCK bytes
+        size_t   fill;          // Bytes waiting in buf
+        bool     failed;        // A write () failed
+
+    OutputBuffer (int outFd) {
+        fd = outFd;
+        buf = new char [OUTPUT_BLOCK];
+        fill = 0;
+        failed = false;
+    }
+
+    ~OutputBuffer (void) {
+        delete [] buf;
+    }
+
+    OutputBuffer (const OutputBuffer &) = delete;
+    OutputBuffer &operator= (const OutputBuffer &) = delete;
+
+    /*  This method returns room for n bytes (at most OUTPUT_BLOCK) at the
+     *  end of the buffer, writing the buffer out first if they do not fit.
+     *  The caller must fill all n bytes.
+     */
+    char *reserve (size_t n) {
+        if (fill + n > OUTPUT_BLOCK)
+            flush ();
+        char *p = buf + fill;
+        fill += n;
+        return p;
+    }
+
+    /*  This method appends n bytes. Blocks larger than the buffer are
+     *  written straight through.
+     */
+    void put (const void *data, size_t n) {
+        if (n > OUTPUT_BLOCK / 2) {
+            flush ();
+            writeAll ((const char *) data, n);
+            return;
+        }
+        memcpy (reserve (n), data, n);
+    }
+
+    /*  This method writes out what is in the buffer. It returns false once
+     *  any write has failed.
+     */
+    bool flush (void) {
+        writeAll (buf, fill);
+        fill = 0;
+        return !failed;
+    }
+
+    void writeAll (const char *p, size_t n) {
+        while (n > 0 && !failed) {
+            ssize_t w = write (fd, p, n);
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0) {
+                failed = true;
+                break;
+            }
+            p += w;
+            n -= w;
+        }
+    }
+
+};
+
+#endif
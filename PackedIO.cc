@@ -0,0 +1,226 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   PackedIO.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Packed binary puzzle files, for storing and moving large
+ *                  batches. A file starts with an 8 byte PackedHeader (the
+ *                  magic "SDKP", a version, the block size of the boards
+ *                  and flags) followed by fixed size records:
+ *
+ *                      status  -   1 byte, the solve () status, 0 in a
+ *                                  file of unsolved puzzles.
+ *                      cells   -   4 bits per cell for 9x9 boards, 5 bits
+ *                                  for 16x16 and 25x25, row by row, low
+ *                                  bits first, 0 for an empty cell.
+ *                      nodes   -   4 bytes little endian, the search nodes
+ *                                  of the solve, only with PACKED_STATS.
+ *
+ *                  A 9x9 record is 42 bytes (46 with the node count),
+ *                  against 82 for a text line and about 500 for the board
+ *                  printout of the single puzzle mode.
+ *
+ *                  The records are converted to and from the text line
+ *                  format of PuzzleIO.cc, so the batch code works on lines
+ *                  either way. PackedRecordReader has the interface of the
+ *                  line readers in PuzzleReader.cc and reads the file
+ *                  PACKED_BLOCK bytes at a time. PackedRecordWriter packs
+ *                  the records straight into an OutputBuffer.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PACKEDIO_CC
+#define PACKEDIO_CC
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include "PuzzleIO.cc"      // One-line-per-puzzle format.
+#include "OutputBuffer.cc"  // Buffered batch output.
+
+#define PACKED_VERSION  1           // Version of the record layout
+#define PACKED_STATS    1           // Header flag: records end with a node count
+#define PACKED_BLOCK    (1 << 20)   // Bytes read at a time
+
+/*  The first 8 bytes of a packed file.
+ */
+struct PackedHeader {
+    char        magic [4];          // "SDKP"
+    uint8_t     version;            // PACKED_VERSION
+    uint8_t     block;              // Block size of the boards, 3 to 5
+    uint8_t     flags;              // PACKED_STATS
+    uint8_t     reserved;
+};
+
+/*  The sizes of the records of one board size.
+ */
+struct PackedLayout {
+
+    int     num;                    // Values, and cells per unit
+    int     cells;                  // Cells of a board
+    int     bits;                   // Bits per cell
+    int     cellBytes;              // Bytes of the packed cells
+    int     record;                 // Bytes of a record
+
+    PackedLayout (int block = 3, int flags = 0) {
+        num = block * block;
+        cells = num * num;
+        bits = num < 16 ? 4 : 5;
+        cellBytes = (cells * bits + 7) / 8;
+        record = 1 + cellBytes + ((flags & PACKED_STATS) ? 4 : 0);
+    }
+
+    /*  This method packs the cells of a text line. Characters that are not
+     *  a value of the board are stored as empty cells.
+     */
+    void pack (const char *line, uint8_t *out) const {
+        memset (out, 0, cellBytes);
+        for (int k = 0; k < cells; k++) {
+            int v = parsePuzzleCell<25> (line[k]);
+            if (v < 0 || v > num)
+                v = 0;
+            int bit = k * bits, at = bit >> 3, shift = bit & 7;
+            out[at] |= (uint8_t) (v << shift);
+            if (shift + bits > 8)
+                out[at + 1] |= (uint8_t) (v >> (8 - shift));
+        }
+    }
+
+    /*  This method writes packed cells back as a text line, '.' for empty
+     *  cells and letters for the values from 10 up.
+     */
+    void unpack (const uint8_t *in, char *line) const {
+        for (int k = 0; k < cells; k++) {
+            int bit = k * bits, at = bit >> 3, shift = bit & 7;
+            int v = in[at] >> shift;
+            if (shift + bits > 8)
+                v |= in[at + 1] << (8 - shift);
+            v &= (1 << bits) - 1;
+            if (v < 1 || v > num)
+                line[k] = '.';
+            else
+                line[k] = v <= 9 ? (char) ('0' + v) : (char) ('A' + v - 10);
+        }
+    }
+
+};
+
+class PackedRecordReader {
+
+    public:
+
+        static const bool STABLE = false;   // next() overwrites the last line
+
+        FILE           *in;         // Input stream
+        PackedHeader    header;     // Header of the file
+        PackedLayout    layout;     // Record sizes of its board size
+        uint8_t        *buf;        // PACKED_BLOCK bytes of the file
+        size_t          fill;       // Bytes in buf
+        size_t          pos;        // Start of the next record in buf
+        char            line [625]; // Current record as a text line
+        long            lineNo;     // Number of the last record returned
+
+    PackedRecordReader (FILE *inFile) {
+        in = inFile;
+        buf = new uint8_t [PACKED_BLOCK];
+        fill = pos = 0;
+        lineNo = 0;
+    }
+
+    ~PackedRecordReader (void) {
+        delete [] buf;
+    }
+
+    PackedRecordReader (const PackedRecordReader &) = delete;
+    PackedRecordReader &operator= (const PackedRecordReader &) = delete;
+
+    /*  This method reads and checks the header. It returns false if the
+     *  input is not a packed file of a known version and board size.
+     */
+    bool open (void) {
+        if (fread (&header, sizeof (header), 1, in) != 1 || memcmp (header.magic, "SDKP", 4) != 0
+            || header.version != PACKED_VERSION || header.block < 3 || header.block > 5)
+            return false;
+        layout = PackedLayout (header.block, header.flags);
+        return true;
+    }
+
+    /*  This method returns the next record as a text line. A record cut off
+     *  by the end of the file is dropped.
+     */
+    bool next (const char *&text, size_t &len) {
+        if (fill - pos < (size_t) layout.record) {
+            memmove (buf, buf + pos, fill - pos);
+            fill -= pos;
+            pos = 0;
+            fill += fread (buf + fill, 1, PACKED_BLOCK - fill, in);
+            if (fill < (size_t) layout.record)
+                return false;
+        }
+        layout.unpack (buf + pos + 1, line);
+        pos += layout.record;
+        lineNo++;
+        text = line;
+        len = layout.cells;
+        return true;
+    }
+
+};
+
+class PackedRecordWriter {
+
+    public:
+
+        OutputBuffer   &out;        // Where the records go
+        PackedLayout    layout;     // Record sizes
+        int             flags;      // PACKED_STATS
+
+    /*  The header is written when the writer is made.
+     */
+    PackedRecordWriter (OutputBuffer &output, int block, int headerFlags = 0)
+        : out (output), layout (block, headerFlags) {
+        flags = headerFlags;
+        PackedHeader h = { { 'S', 'D', 'K', 'P' }, PACKED_VERSION, (uint8_t) block, (uint8_t) flags, 0 };
+        out.put (&h, sizeof (h));
+    }
+
+    /*  This method adds the record of one result line. 'nodes' is only
+     *  stored with PACKED_STATS.
+     */
+    void put (const char *line, int status, long nodes = 0) {
+        uint8_t *r = (uint8_t *) out.reserve (layout.record);
+        r[0] = (uint8_t) status;
+        layout.pack (line, r + 1);
+        if (flags & PACKED_STATS) {
+            uint32_t n = nodes < 0 ? 0 : nodes > 0xffffffffL ? 0xffffffffu : (uint32_t) nodes;
+            uint8_t *p = r + 1 + layout.cellBytes;
+            p[0] = (uint8_t) n;
+            p[1] = (uint8_t) (n >> 8);
+            p[2] = (uint8_t) (n >> 16);
+            p[3] = (uint8_t) (n >> 24);
+        }
+    }
+
+};
+
+#endif
@@ -0,0 +1,437 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   PuzzleGenerator.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Puzzle generation: a random full grid, then clues taken
+ *                  away one at a time for as long as the puzzle keeps a
+ *                  single solution.
+ *
+ *                  The full grid comes from the solver itself. The blocks
+ *                  on the diagonal do not share a unit, so each gets a
+ *                  random permutation, the search fills in the rest and
+ *                  the grid is then relabelled and its rows, columns,
+ *                  bands and stacks shuffled, none of which breaks it.
+ *
+ *                  Clues are tried in a random order, every try being a
+ *                  countSolutions (2) that stops at the second solution.
+ *                  The tries of one round run in parallel, one candidate
+ *                  cell per thread, each on a solver that lives as long as
+ *                  the generator. Two removals that each keep the puzzle
+ *                  unique need not do so together, so the cells that pass
+ *                  are then checked as growing prefixes, again in
+ *                  parallel, and the longest unique prefix is taken. A
+ *                  cell that fails on a puzzle fails on every puzzle with
+ *                  fewer clues and is kept for good; the cells past the
+ *                  first failing prefix are tried again in a later round.
+ *                  Early on, when nearly everything can go, a round takes
+ *                  away one clue per thread.
+ *
+ *                  The difficulty of a puzzle is the search nodes of its
+ *                  uniqueness check, the count the solver keeps in 'nodes'
+ *                  and SolveStats, and packed records carry: 0 for a
+ *                  puzzle the logical solver finishes, more the more the
+ *                  search has to guess. A GenerateBand bounds it. A clue
+ *                  is only taken away if the puzzle stays below the top of
+ *                  the band, and a grid whose puzzle ends below the bottom
+ *                  is thrown away for a new one, up to GENERATE_TRIES.
+ *
+ *                  The rounds take away the clues that trying the cells
+ *                  one after the other would, so without a top to the band
+ *                  the puzzles only depend on the seed. With one they may
+ *                  also depend on the thread count, as difficulty does not
+ *                  always grow as clues go.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PUZZLEGENERATOR_CC
+#define PUZZLEGENERATOR_CC
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+
+#define GENERATE_TRIES  1000    // Full grids tried per puzzle before the band is given up
+#define GENERATE_SPIN   2000    // Polls of an idle helper before it goes to sleep
+
+#define CELL_OPEN       0       // Clue not tried yet, or to be tried again
+#define CELL_KEPT       1       // Clue the puzzle cannot do without
+#define CELL_REMOVED    2       // Clue taken away
+
+/*  Range of the search nodes of a generated puzzle, see PuzzleGenerator.cc.
+ */
+struct GenerateBand {
+    long    minNodes;   // Fewest nodes
+    long    maxNodes;   // Most nodes, -1 for no bound
+};
+
+/*  Named bands of --band, from the nodes of 9x9 minimal puzzles.
+ */
+struct GenerateBandName {
+    const char     *name;
+    GenerateBand    band;
+};
+
+static const GenerateBandName generateBands [] = {
+    { "easy",       { 0, 0 } },         // The logical solver needs no guess
+    { "medium",     { 1, 6 } },         // About 40% of them each
+    { "hard",       { 7, 20 } },
+    { "expert",     { 21, -1 } },       // Some 3%
+    { "any",        { 0, -1 } },
+};
+
+/*  This function reads a band, one of the names above or "MIN-MAX" in
+ *  nodes, where MAX may be left out for no bound. It returns false if the
+ *  text is neither.
+ */
+inline bool parseGenerateBand (const char *text, GenerateBand &band) {
+    for (size_t k = 0; k < sizeof (generateBands) / sizeof (generateBands[0]); k++)
+        if (strcmp (text, generateBands[k].name) == 0) {
+            band = generateBands[k].band;
+            return true;
+        }
+    char *end;
+    long lo = strtol (text, &end, 10);
+    if (end == text || *end != '-' || lo < 0)
+        return false;
+    const char *rest = end + 1;
+    long hi = *rest != 0 ? strtol (rest, &end, 10) : -1;
+    if ((*rest != 0 && (end == rest || *end != 0)) || (hi >= 0 && hi < lo))
+        return false;
+    band = GenerateBand { lo, hi };
+    return true;
+}
+
+template <int B>
+class BasicPuzzleGenerator {
+
+    public:
+
+        typedef BasicSudokuSolver<B> Solver;
+        typedef typename Solver::Grid Grid;
+        static constexpr int NUM = Solver::NUM;
+        static constexpr int CELLS = Solver::CELLS;
+
+        /*  One uniqueness check: the puzzle without picked[first] up to
+         *  picked[first + count - 1].
+         */
+        struct Check {
+            int     first;
+            int     count;
+            int     found;      // countSolutions (2), -1 if a limit ran out
+            long    nodes;      // Search nodes of the check
+        };
+
+        int                     threads;        // Workers, the calling thread included
+        GenerateBand            band;           // Difficulty of the puzzles
+        int                     tries;          // Full grids per puzzle at most
+        SolveLimits             limits;         // Limits of every solve
+        uint64_t                state;          // Random number state
+        long                    rating;         // Search nodes of the last puzzle
+        int                     clues;          // Givens of the last puzzle
+        long                    grids;          // Full grids made so far
+        long                    checks;         // Uniqueness checks run so far
+        Solver                 *solvers;        // One per worker
+        Check                  *jobs;           // Checks of the round, one per worker
+        int                    *picked;         // Candidate cells of the round
+        int                     jobCount;
+        uint8_t                 cells [CELLS];  // Puzzle being thinned out, 0 for empty
+        uint8_t                 fate [CELLS];   // CELL_OPEN, CELL_KEPT or CELL_REMOVED
+        int                     order [CELLS];  // Cells in the order they are tried
+        std::atomic<int>        nextJob;        // Next check to claim
+        std::atomic<int>        busy;           // Helpers still checking
+        std::atomic<unsigned>   generation;     // Rounds started
+        std::mutex              lock;
+        std::condition_variable started;        // Signalled when a round starts
+        std::condition_variable finished;       // Signalled when the last helper is done
+        bool                    stopping;       // Set under 'lock' by the destructor
+        std::vector<std::thread> helpers;
+
+    BasicPuzzleGenerator (int threadCount, uint64_t seed) {
+        threads = threadCount < 1 ? 1 : threadCount;
+        band = GenerateBand { 0, -1 };
+        tries = GENERATE_TRIES;
+        limits = SolveLimits { 0, 0, NULL };
+        state = seed * 0x9E3779B97F4A7C15ull + 1; // Never 0, which xorshift cannot leave.
+        rating = 0;
+        clues = 0;
+        grids = 0;
+        checks = 0;
+        solvers = new Solver [threads];
+        jobs = new Check [threads];
+        picked = new int [threads];
+        jobCount = 0;
+        busy.store (0);
+        generation.store (0);
+        stopping = false;
+        for (int k = 1; k < threads; k++)
+            helpers.push_back (std::thread (&BasicPuzzleGenerator::helper, this, k));
+    }
+
+    ~BasicPuzzleGenerator (void) {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            stopping = true;
+        }
+        started.notify_all ();
+        for (size_t k = 0; k < helpers.size (); k++)
+            helpers[k].join ();
+        delete [] solvers;
+        delete [] jobs;
+        delete [] picked;
+    }
+
+    BasicPuzzleGenerator (const BasicPuzzleGenerator &) = delete;
+    BasicPuzzleGenerator &operator= (const BasicPuzzleGenerator &) = delete;
+
+    /*  This method makes one puzzle with a single solution, in the band,
+     *  and writes it to 'puzzle' with 0 for the empty cells. It returns
+     *  SOLVE_OK, or SOLVE_BUDGET if no grid in 'tries' gave a puzzle hard
+     *  enough for the band.
+     */
+    int generate (Grid &puzzle) {
+        for (int t = 0; t < tries; t++) {
+            if (!fillGrid ())
+                continue;
+            removeClues ();
+            if (rating >= band.minNodes) {
+                for (int k = 0; k < CELLS; k++)
+                    puzzle[k / NUM][k % NUM] = cells[k];
+                return SOLVE_OK;
+            }
+        }
+        return SOLVE_BUDGET;
+    }
+
+    /*  This method returns the next random number, xorshift64*.
+     */
+    uint64_t random (void) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    /*  This method shuffles the n entries of 'a'.
+     */
+    void shuffle (int *a, int n) {
+        for (int k = n - 1; k > 0; k--) {
+            int m = (int) (random () % (uint64_t) (k + 1));
+            int t = a[k];
+            a[k] = a[m];
+            a[m] = t;
+        }
+    }
+
+    /*  This method fills 'cells' with a random full grid. It returns false
+     *  if the search ran out of its limits first.
+     */
+    bool fillGrid (void) {
+        Grid grid;
+        int perm [NUM];
+        memset (grid, 0, sizeof (grid));
+        for (int b = 0; b < B; b++) { // The diagonal blocks share no unit.
+            for (int n = 0; n < NUM; n++)
+                perm[n] = n + 1;
+            shuffle (perm, NUM);
+            for (int n = 0; n < NUM; n++)
+                grid[b * B + n / B][b * B + n % B] = perm[n];
+        }
+        Solver &S = solvers[0];
+        S.limits = limits;
+        if (S.solve (grid, grid) != SOLVE_OK)
+            return false;
+        grids++;
+
+        int digit [NUM + 1], rows [NUM], cols [NUM], bands [B], stacks [B];
+        for (int n = 0; n < NUM; n++)
+            perm[n] = n + 1;
+        shuffle (perm, NUM);
+        digit[0] = 0;
+        for (int n = 0; n < NUM; n++)
+            digit[n + 1] = perm[n];
+        for (int b = 0; b < B; b++)
+            bands[b] = stacks[b] = b;
+        shuffle (bands, B);
+        shuffle (stacks, B);
+        for (int b = 0; b < B; b++) {
+            for (int r = 0; r < B; r++) {
+                rows[b * B + r] = bands[b] * B + r;
+                cols[b * B + r] = stacks[b] * B + r;
+            }
+            shuffle (rows + b * B, B);
+            shuffle (cols + b * B, B);
+        }
+        bool transpose = random () & 1;
+        for (int i = 0; i < NUM; i++)
+            for (int j = 0; j < NUM; j++) {
+                int v = transpose ? grid[rows[j]][cols[i]] : grid[rows[i]][cols[j]];
+                cells[i * NUM + j] = (uint8_t) digit[v];
+            }
+        return true;
+    }
+
+    /*  This method takes clues away from the full grid in 'cells' until
+     *  every clue left is needed for a single solution, or for the band,
+     *  and sets 'rating' and 'clues'.
+     */
+    void removeClues (void) {
+        for (int k = 0; k < CELLS; k++) {
+            order[k] = k;
+            fate[k] = CELL_OPEN;
+        }
+        shuffle (order, CELLS);
+        rating = 0;
+        clues = CELLS;
+        int at = 0;
+
+        while (true) {
+            while (at < CELLS && fate[order[at]] != CELL_OPEN)
+                at++;
+            int n = 0;
+            for (int k = at; k < CELLS && n < threads; k++)
+                if (fate[order[k]] == CELL_OPEN)
+                    picked[n++] = order[k];
+            if (n == 0)
+                return;
+
+            for (int w = 0; w < n; w++)
+                jobs[w] = Check { w, 1, 0, 0 };
+            run (n);
+            int good = 0;
+            for (int w = 0; w < n; w++) { // Move the cells that passed to the front.
+                if (!accepted (jobs[w])) {
+                    fate[picked[w]] = CELL_KEPT;
+                    continue;
+                }
+                jobs[good].nodes = jobs[w].nodes;
+                picked[good++] = picked[w];
+            }
+            if (good == 0)
+                continue;
+
+            int take = 1;
+            long nodes = jobs[0].nodes;
+            if (good > 1) {
+                for (int p = 0; p < good - 1; p++)
+                    jobs[p] = Check { 0, p + 2, 0, 0 };
+                run (good - 1);
+                for (; take < good && accepted (jobs[take - 1]); take++)
+                    nodes = jobs[take - 1].nodes;
+                if (take < good) // Fails next to the prefix that is taken away.
+                    fate[picked[take]] = CELL_KEPT;
+            }
+            for (int q = 0; q < take; q++) {
+                cells[picked[q]] = 0;
+                fate[picked[q]] = CELL_REMOVED;
+            }
+            clues -= take;
+            rating = nodes;
+        }
+    }
+
+    /*  This method returns true if the check leaves a single solution
+     *  within the band.
+     */
+    bool accepted (const Check &c) {
+        return c.found == 1 && (band.maxNodes < 0 || c.nodes <= band.maxNodes);
+    }
+
+    /*  This method runs the first n checks of 'jobs', on the helpers too if
+     *  there is more than one.
+     */
+    void run (int n) {
+        jobCount = n;
+        nextJob.store (0);
+        checks += n;
+        if (n == 1 || threads == 1) {
+            work (0);
+            return;
+        }
+        busy.store (threads - 1);
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            generation.fetch_add (1, std::memory_order_release);
+        }
+        started.notify_all ();
+        work (0);
+        for (int s = 0; s < GENERATE_SPIN && busy.load (std::memory_order_acquire) > 0; s++)
+            std::this_thread::yield ();
+        std::unique_lock<std::mutex> guard (lock);
+        while (busy.load (std::memory_order_acquire) > 0)
+            finished.wait (guard);
+    }
+
+    /*  This method claims checks and runs them on worker id's solver until
+     *  none are left.
+     */
+    void work (int id) {
+        Solver &S = solvers[id];
+        S.limits = limits;
+        int t;
+        while ((t = nextJob.fetch_add (1, std::memory_order_relaxed)) < jobCount) {
+            Check &c = jobs[t];
+            Grid grid;
+            for (int k = 0; k < CELLS; k++)
+                grid[k / NUM][k % NUM] = cells[k];
+            for (int q = c.first; q < c.first + c.count; q++)
+                grid[picked[q] / NUM][picked[q] % NUM] = 0;
+            c.found = S.countSolutions (grid, 2);
+            c.nodes = S.nodes;
+        }
+    }
+
+    /*  This is the loop of one helper thread: it polls for the next round
+     *  for a while, as rounds follow each other closely, then sleeps.
+     */
+    void helper (int id) {
+        unsigned seen = 0;
+        while (true) {
+            for (int s = 0; s < GENERATE_SPIN && generation.load (std::memory_order_acquire) == seen; s++)
+                std::this_thread::yield ();
+            {
+                std::unique_lock<std::mutex> guard (lock);
+                while (!stopping && generation.load (std::memory_order_acquire) == seen)
+                    started.wait (guard);
+                if (stopping)
+                    return;
+                seen = generation.load (std::memory_order_acquire);
+            }
+            work (id);
+            if (busy.fetch_sub (1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> guard (lock); // The caller is waiting or has not looked yet.
+            }
+            finished.notify_one ();
+        }
+    }
+
+};
+
+typedef BasicPuzzleGenerator<3> PuzzleGenerator;   // Generator of 9x9 puzzles
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   PuzzleIO.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Helpers for the one-line-per-puzzle format used by puzzle
+ *                  collections. Each line holds the 81 cells row after row.
+ *                  The digits 1 to 9 are givens, '.' or '0' is an empty cell.
+ *                  Anything after the 81st cell (such as a trailing '\r') is
+ *                  ignored.
+ *
+ *                  The helpers are templates on the grid size, so the same
+ *                  format also holds the 16x16 and 25x25 boards (256 or 625
+ *                  cells per line). The values from 10 up are written as
+ *                  the letters 'A', 'B', ... (lower case is read as well).
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PUZZLEIO_CC
+#define PUZZLEIO_CC
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+
+#define PUZZLE_LINE_CELLS   81  // Cells in one 9x9 puzzle line
+
+/*  This function returns the value of one cell character, 0 for an empty
+ *  cell or -1 if the character is not a value of an N x N board.
+ */
+template <int N>
+inline int parsePuzzleCell (char c) {
+    int n;
+    if (c == '.' || c == '0')
+        return 0;
+    if (c >= '1' && c <= '9')
+        n = c - '0';
+    else if (c >= 'A' && c <= 'Z')
+        n = c - 'A' + 10;
+    else if (c >= 'a' && c <= 'z')
+        n = c - 'a' + 10;
+    else
+        return -1;
+    return n <= N ? n : -1;
+}
+
+/*  This function reads the first N * N characters of a puzzle line into
+ *  the grid. It returns false if the line is too short or holds a
+ *  character that is not a value or '.', and the grid is then undefined.
+ */
+template <int N>
+inline bool parsePuzzleLine (const char *line, size_t len, int (&grid) [N][N]) {
+    if (len < (size_t) (N * N))
+        return false;
+    for (int k = 0; k < N * N; k++) {
+        int n = parsePuzzleCell<N> (line[k]);
+        if (n < 0)
+            return false;
+        grid[k / N][k % N] = n;
+    }
+    return true;
+}
+
+/*  This function writes the N * N cells of the grid to 'line' in the same
+ *  format, using '.' for empty cells. No newline or terminator is added.
+ */
+template <int N>
+inline void formatPuzzleLine (const int (&grid) [N][N], char *line) {
+    for (int k = 0; k < N * N; k++) {
+        int n = grid[k / N][k % N];
+        if (n < 1 || n > N)
+            line[k] = '.';
+        else
+            line[k] = n <= 9 ? (char) ('0' + n) : (char) ('A' + n - 10);
+    }
+}
+
+/*  This function copies a line that could not be solved to 'out' as it was
+ *  read, cut or padded with '.' to the N * N cells of a line.
+ */
+template <int N>
+inline void echoPuzzleLine (const char *line, size_t len, char *out) {
+    const size_t cells = N * N;
+    size_t n = len < cells ? len : cells;
+    memcpy (out, line, n);
+    memset (out + n, '.', cells - n);
+}
+
+/*  This function solves one puzzle line with the given solver and writes
+ *  the CELLS character result to 'out'. A line that cannot be parsed or
+ *  solved is copied to 'out' as it was read (padded with '.' if it is too
+ *  short) and the failing status is returned. 'unique' is passed on to
+ *  solve().
+ */
+template <class Solver>
+inline int solvePuzzleLine (Solver &SS, const char *line, size_t len, char *out, bool unique = false) {
+    typename Solver::Grid grid;
+    int status = SOLVE_INVALID;
+    SS.conflict = SolveConflict { -1, -1, -1, 0 };
+    if (parsePuzzleLine (line, len, grid))
+        status = SS.solve (grid, grid, unique);
+    if (status == SOLVE_OK) {
+        formatPuzzleLine (grid, out);
+        return status;
+    }
+    echoPuzzleLine<Solver::NUM> (line, len, out);
+    return status;
+}
+
+/*  This function writes where an N x N puzzle failed to 'buf', as a
+ *  sentence that follows statusMessage (), and returns 'buf'. It is empty
+ *  if the solver recorded nothing.
+ */
+template <int N>
+inline const char *describeConflict (const SolveConflict &c, char *buf, size_t size) {
+    static const char *unitNames [3] = { "row", "column", "block" };
+    char value = c.value <= 9 ? (char) ('0' + c.value) : (char) ('A' + c.value - 10);
+    if (c.cell >= 0 && c.other >= 0)
+        snprintf (buf, size, " %c at row %d column %d clashes with row %d column %d.",
+                  value, c.cell / N + 1, c.cell % N + 1, c.other / N + 1, c.other % N + 1);
+    else if (c.cell >= 0)
+        snprintf (buf, size, " Row %d column %d has no candidate left.", c.cell / N + 1, c.cell % N + 1);
+    else if (c.unit >= 0)
+        snprintf (buf, size, " %c has no place left in %s %d.", value, unitNames[c.unit / N], c.unit % N + 1);
+    else if (size > 0)
+        buf[0] = 0;
+    return buf;
+}
+
+/*  This function returns the error message for a failing solve status.
+ */
+inline const char *statusMessage (int status) {
+    switch (status) {
+        case SOLVE_OK:          return "solved.";
+        case SOLVE_UNSOLVABLE:  return "puzzle cannot be solved.";
+        case SOLVE_MULTIPLE:    return "puzzle has more than one solution.";
+        case SOLVE_BUDGET:      return "solve limit reached.";
+        default:                return "invalid puzzle.";
+    }
+}
+
+#endif
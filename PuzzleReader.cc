@@ -0,0 +1,150 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   PuzzleReader.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Line readers for the batch solvers. Both hand out one
+ *                  non-empty puzzle line at a time, without the newline, and
+ *                  number the lines for error messages.
+ *
+ *                  MappedLineReader maps the whole input file and returns
+ *                  pointers straight into the mapped pages, so the bytes are
+ *                  never copied and stay valid for as long as the reader
+ *                  lives. StdioLineReader is the fallback for pipes and
+ *                  stdin; its lines live in one buffer that the next call
+ *                  overwrites.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef PUZZLEREADER_CC
+#define PUZZLEREADER_CC
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+class MappedLineReader {
+
+    public:
+
+        static const bool STABLE = true;    // Lines stay valid after next()
+
+        const char  *base;      // Start of the mapping, NULL if not mapped
+        size_t       size;      // Bytes mapped
+        const char  *pos;       // Start of the next line
+        long         lineNo;    // Number of the last line returned
+
+    MappedLineReader (void) {
+        base = pos = NULL;
+        size = 0;
+        lineNo = 0;
+    }
+
+    ~MappedLineReader (void) {
+        if (base != NULL)
+            munmap ((void *) base, size);
+    }
+
+    /*  This method maps the whole file read-only. It returns false if the
+     *  file cannot be mapped (a pipe, a terminal, or an empty file), in
+     *  which case the caller should fall back to StdioLineReader.
+     */
+    bool open (int fd) {
+        struct stat st;
+        if (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode) || st.st_size == 0)
+            return false;
+        void *p = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+            return false;
+        madvise (p, st.st_size, MADV_SEQUENTIAL); // Let the kernel read ahead.
+        base = pos = (const char *) p;
+        size = st.st_size;
+        return true;
+    }
+
+    /*  This method returns the next non-empty line. A trailing '\r' is
+     *  stripped. It returns false at the end of the file.
+     */
+    bool next (const char *&line, size_t &len) {
+        const char *end = base + size;
+        while (pos < end) {
+            const char *nl = (const char *) memchr (pos, '\n', end - pos);
+            const char *stop = nl ? nl : end;
+            line = pos;
+            len = stop - pos;
+            pos = nl ? nl + 1 : end;
+            lineNo++;
+            while (len > 0 && line[len - 1] == '\r')
+                len--;
+            if (len > 0)
+                return true;
+        }
+        return false;
+    }
+
+};
+
+class StdioLineReader {
+
+    public:
+
+        static const bool STABLE = false;   // next() overwrites the last line
+
+        FILE    *in;            // Input stream
+        char     buf [1024];    // Current line
+        long     lineNo;        // Number of the last line returned
+
+    StdioLineReader (FILE *inFile) {
+        in = inFile;
+        lineNo = 0;
+    }
+
+    /*  This method returns the next non-empty line, like the mapped reader.
+     *  Lines longer than the buffer are cut; a puzzle only needs its first
+     *  625 characters, at the largest board size.
+     */
+    bool next (const char *&line, size_t &len) {
+        while (fgets (buf, sizeof (buf), in)) {
+            len = strlen (buf);
+            lineNo++;
+            if (len == sizeof (buf) - 1 && buf[len - 1] != '\n') { // Overlong line, drop the rest.
+                int c;
+                while ((c = getc (in)) != EOF && c != '\n')
+                    ;
+            }
+            while (len > 0 && (buf[len - 1] == '\n' || buf[len - 1] == '\r'))
+                len--;
+            if (len > 0) {
+                line = buf;
+                return true;
+            }
+        }
+        return false;
+    }
+
+};
+
+#endif
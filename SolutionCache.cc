@@ -0,0 +1,538 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   SolutionCache.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Solution cache for 9x9 puzzles keyed by their canonical
+ *                  form, so a puzzle that was seen before, or a relabelled,
+ *                  transposed or row / column / band / stack permuted copy of
+ *                  it, is answered by a lookup instead of a solve.
+ *
+ *                  PuzzleCanonizer finds the smallest form of a puzzle over
+ *                  its 2 * 1296 * 1296 = 3359232 geometric variants, with the
+ *                  digits relabelled 1, 2, ... in order of first appearance.
+ *                  Empty cells sort after every digit, so the canonical form
+ *                  starts with the densest rows, givens first. It does not
+ *                  try every variant: the rows are placed one at a time and
+ *                  only the partial variants that tie for the smallest
+ *                  prefix are kept (at most CANON_BEAM of them, a puzzle
+ *                  with more ties, nearly empty ones, is not cached). The
+ *                  transform of the first survivor maps solutions between
+ *                  the puzzle and its canonical form.
+ *
+ *                  SolutionCache maps canonical forms to canonical
+ *                  solutions. It is split into CACHE_SHARDS shards, each
+ *                  with its own lock, a fixed array of entries in LRU order
+ *                  and a chained hash index, all allocated when the cache is
+ *                  made. Lookups and inserts never allocate; an insert into
+ *                  a full shard reuses its least recently used entry.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SOLUTIONCACHE_CC
+#define SOLUTIONCACHE_CC
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdint.h>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+#include "PuzzleIO.cc"      // One-line-per-puzzle format.
+
+#define CANON_BEAM      1024    // Tied partial variants kept by PuzzleCanonizer
+#define CACHE_SHARDS    16      // Independently locked parts of a SolutionCache
+
+/*  The 1296 orders of the 9 columns that keep the stacks together: the
+ *  stacks in any order and the columns of each stack in any order.
+ */
+struct CanonTables {
+
+    uint8_t     perm [6][3];            // The orders of 3 things
+    uint8_t     arrangement [1296][9];  // Source column of each position
+
+    constexpr CanonTables (void) : perm { {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0} },
+                                   arrangement () {
+        for (int a = 0; a < 1296; a++) {
+            int s = a / 216, p [3] = { a / 36 % 6, a / 6 % 6, a % 6 };
+            for (int j = 0; j < 9; j++)
+                arrangement[a][j] = (uint8_t) (3 * perm[s][j / 3] + perm[p[j / 3]][j % 3]);
+        }
+    }
+};
+
+/*  A transform from a puzzle to its canonical form: canonical cell (i, j)
+ *  is the puzzle's cell (row[i], col[j]), of the transposed puzzle if
+ *  'transpose' is set, with its value v written as label[v].
+ */
+struct PuzzleTransform {
+    bool        transpose;
+    uint8_t     row [9];
+    uint8_t     col [9];
+    uint8_t     label [10];                 // label[0] is 0, the empty cell
+};
+
+class PuzzleCanonizer {
+
+    public:
+
+        /*  One partial variant: the rows placed so far, the column order
+         *  and the labels given out so far.
+         */
+        struct State {
+            PuzzleTransform t;
+            uint8_t     labelled;               // Labels given out
+            uint8_t     bands;                  // Bit per source band used
+        };
+
+        static constexpr CanonTables tables = CanonTables ();
+
+        uint8_t     cells [2][81];              // The puzzle and its transpose
+        uint8_t     key [81];                   // Canonical form, 0 for empty
+        PuzzleTransform transform;              // Puzzle to canonical form
+        State       beam [2][CANON_BEAM];       // Survivors of the last row, next row
+        int         beamLen [2];
+
+    /*  This method finds the canonical form of the puzzle. It returns false
+     *  if the puzzle has too many tied variants to be canonicalised within
+     *  CANON_BEAM.
+     */
+    bool canonicalize (const SudokuSolver::Grid &grid) {
+        for (int i = 0; i < 9; i++)
+            for (int j = 0; j < 9; j++) {
+                int v = grid[i][j];
+                cells[0][i * 9 + j] = cells[1][j * 9 + i] = (uint8_t) ((v >= 1 && v <= 9) ? v : 0);
+            }
+        if (!placeFirstRow ())
+            return false;
+        int cur = 0;
+        for (int i = 1; i < 9; i++) {
+            if (!placeRow (i, beam[cur], beamLen[cur], beam[1 - cur], beamLen[1 - cur]))
+                return false;
+            cur = 1 - cur;
+        }
+        transform = beam[cur][0].t;
+        uint8_t next = beam[cur][0].labelled;
+        for (int v = 1; v <= 9; v++) // Digits the puzzle does not use.
+            if (transform.label[v] == 0)
+                transform.label[v] = ++next;
+        return true;
+    }
+
+    /*  This function orders rendered cells: labels 1 to 9 ascending, then
+     *  the empty cell.
+     */
+    static uint8_t rank (uint8_t label) {
+        return (uint8_t) (label - 1);
+    }
+
+    /*  This method renders source row r of orientation t through column
+     *  order 'col' into 'out', giving new labels from 's', and compares it
+     *  with the best row 'best' so far. It stops at the first cell that
+     *  is worse. It returns -1, 0 or 1 as the row is smaller, equal or
+     *  larger; 's' is only updated when it is not larger.
+     */
+    int renderRow (int t, int r, const uint8_t *col, State &s, uint8_t *out, const uint8_t *best, bool haveBest) {
+        uint8_t label [10], next = s.labelled;
+        int order = haveBest ? 0 : -1;
+        memcpy (label, s.t.label, sizeof (label));
+        for (int j = 0; j < 9; j++) {
+            uint8_t v = cells[t][r * 9 + col[j]];
+            if (v != 0 && label[v] == 0)
+                label[v] = ++next;
+            out[j] = label[v];
+            if (order == 0 && rank (out[j]) != rank (best[j]))
+                order = rank (out[j]) < rank (best[j]) ? -1 : 1;
+            if (order > 0)
+                return 1;
+        }
+        memcpy (s.t.label, label, sizeof (label));
+        s.labelled = next;
+        return order;
+    }
+
+    /*  This method returns the givens of source row r of orientation t as
+     *  a bit per column, bit 8 for column 0, once the columns are put in
+     *  the best order for it: the stacks with the most givens first, the
+     *  givens first in each stack. The first row has no labels yet, so
+     *  its rendering only depends on where the givens are, and the larger
+     *  this pattern the smaller the rendered row.
+     */
+    int rowPattern (int t, int r) {
+        int count [3] = { 0, 0, 0 };
+        for (int c = 0; c < 9; c++)
+            count[c / 3] += cells[t][r * 9 + c] != 0;
+        if (count[0] < count[1]) std::swap (count[0], count[1]);
+        if (count[1] < count[2]) std::swap (count[1], count[2]);
+        if (count[0] < count[1]) std::swap (count[0], count[1]);
+        int pattern = 0;
+        for (int s = 0; s < 3; s++)
+            pattern = (pattern << 3) | ((7 << (3 - count[s])) & 7);
+        return pattern;
+    }
+
+    /*  This method places the first row: the source rows with the best
+     *  pattern, in every column order that gives it. Arrangement s * 216 +
+     *  p0 * 36 + p1 * 6 + p2 puts the stacks in order perm[s] and the
+     *  columns of the stack at position j in order perm[pj].
+     */
+    bool placeFirstRow (void) {
+        int best = -1;
+        for (int t = 0; t < 2; t++)
+            for (int r = 0; r < 9; r++)
+                best = std::max (best, rowPattern (t, r));
+        bool overflow = false;
+        beamLen[0] = 0;
+        for (int t = 0; t < 2; t++)
+            for (int r = 0; r < 9; r++) {
+                if (rowPattern (t, r) != best)
+                    continue;
+                const uint8_t *given = cells[t] + r * 9;
+                int count [3], fits [3][6], fitsLen [3];
+                for (int x = 0; x < 3; x++) {
+                    count[x] = (given[3 * x] != 0) + (given[3 * x + 1] != 0) + (given[3 * x + 2] != 0);
+                    fitsLen[x] = 0;
+                    for (int p = 0; p < 6; p++) { // Column orders of stack x with its givens first.
+                        const uint8_t *o = tables.perm[p];
+                        if ((given[3 * x + o[0]] != 0) >= (given[3 * x + o[1]] != 0) &&
+                            (given[3 * x + o[1]] != 0) >= (given[3 * x + o[2]] != 0))
+                            fits[x][fitsLen[x]++] = p;
+                    }
+                }
+                for (int so = 0; so < 6; so++) {
+                    const uint8_t *o = tables.perm[so];
+                    if (count[o[0]] < count[o[1]] || count[o[1]] < count[o[2]])
+                        continue;
+                    for (int a0 = 0; a0 < fitsLen[o[0]]; a0++)
+                        for (int a1 = 0; a1 < fitsLen[o[1]]; a1++)
+                            for (int a2 = 0; a2 < fitsLen[o[2]]; a2++) {
+                                if (beamLen[0] == CANON_BEAM) {
+                                    overflow = true;
+                                    continue;
+                                }
+                                const uint8_t *col = tables.arrangement[so * 216 + fits[o[0]][a0] * 36 +
+                                                                        fits[o[1]][a1] * 6 + fits[o[2]][a2]];
+                                State &s = beam[0][beamLen[0]++];
+                                memset (&s, 0, sizeof (s));
+                                s.t.transpose = t;
+                                s.t.row[0] = (uint8_t) r;
+                                memcpy (s.t.col, col, 9);
+                                s.bands = (uint8_t) (1 << (r / 3));
+                                renderRow (t, r, col, s, key, key, false);
+                            }
+                }
+            }
+        return !overflow;
+    }
+
+    /*  This method places row i (1 to 8): a row of an unused band at the
+     *  start of a band, otherwise an unused row of the current band.
+     */
+    bool placeRow (int i, const State *from, int fromLen, State *to, int &toLen) {
+        uint8_t *best = key + i * 9;
+        bool overflow = false;
+        toLen = 0;
+        for (int k = 0; k < fromLen; k++) {
+            const State &base = from[k];
+            for (int r = 0; r < 9; r++) {
+                if (i % 3 == 0 ? (base.bands >> (r / 3)) & 1 : r / 3 != base.t.row[i - 1] / 3)
+                    continue;
+                bool used = false;
+                for (int p = i % 3 == 0 ? i : i - i % 3; p < i; p++)
+                    used |= base.t.row[p] == r;
+                if (used)
+                    continue;
+                State s = base;
+                uint8_t out [9];
+                int order = renderRow (s.t.transpose, r, s.t.col, s, out, best, toLen > 0);
+                if (order > 0)
+                    continue;
+                if (order < 0) {
+                    memcpy (best, out, 9);
+                    toLen = 0;
+                    overflow = false;
+                }
+                if (toLen == CANON_BEAM) { // Only fatal if nothing smaller turns up.
+                    overflow = true;
+                    continue;
+                }
+                s.t.row[i] = (uint8_t) r;
+                s.bands |= (uint8_t) (1 << (r / 3));
+                to[toLen++] = s;
+            }
+        }
+        return !overflow;
+    }
+
+    /*  This method returns a 64 bit hash of the canonical form.
+     */
+    uint64_t hash (void) {
+        uint64_t h = 0x9e3779b97f4a7c15ull;
+        for (int k = 0; k < 81; k++)
+            h = (h ^ key[k]) * 0x100000001b3ull;
+        return h ^ (h >> 29);
+    }
+
+    /*  These methods map a full grid between the puzzle and the canonical
+     *  form.
+     */
+    void toCanonical (const SudokuSolver::Grid &grid, uint8_t *canon) {
+        for (int i = 0; i < 9; i++)
+            for (int j = 0; j < 9; j++) {
+                int r = transform.row[i], c = transform.col[j];
+                canon[i * 9 + j] = transform.label[transform.transpose ? grid[c][r] : grid[r][c]];
+            }
+    }
+
+    void fromCanonical (const uint8_t *canon, SudokuSolver::Grid &grid) {
+        uint8_t value [10] = { 0 };
+        for (int v = 1; v <= 9; v++)
+            value[transform.label[v]] = (uint8_t) v;
+        for (int i = 0; i < 9; i++)
+            for (int j = 0; j < 9; j++) {
+                int r = transform.row[i], c = transform.col[j];
+                (transform.transpose ? grid[c][r] : grid[r][c]) = value[canon[i * 9 + j]];
+            }
+    }
+
+};
+
+class SolutionCache {
+
+    public:
+
+        /*  One cached puzzle. 'status' is a solve () result; 'unique' is
+         *  set if it came from a solve with the uniqueness check.
+         */
+        struct Entry {
+            uint64_t    hash;
+            uint8_t     key [81];
+            uint8_t     solution [81];
+            uint8_t     status;
+            uint8_t     unique;
+            int32_t     prev;                   // LRU list, most recent first
+            int32_t     next;
+            int32_t     chain;                  // Next entry of the hash bucket
+        };
+
+        struct Shard {
+            std::mutex  lock;
+            Entry      *entries;                // 'capacity' entries
+            int32_t    *buckets;                // Heads of the hash chains, -1 if empty
+            int32_t     capacity;
+            int32_t     mask;                   // Buckets - 1
+            int32_t     used;                   // Entries filled so far
+            int32_t     head;                   // Most recently used entry
+            int32_t     tail;                   // Least recently used entry
+            long        hits;
+            long        misses;
+        };
+
+        Shard       shards [CACHE_SHARDS];
+
+    SolutionCache (long capacity) {
+        int32_t per = (int32_t) ((capacity + CACHE_SHARDS - 1) / CACHE_SHARDS);
+        if (per < 1)
+            per = 1;
+        int32_t buckets = 1;
+        while (buckets < 2 * per)
+            buckets <<= 1;
+        for (int s = 0; s < CACHE_SHARDS; s++) {
+            Shard &sh = shards[s];
+            sh.entries = new Entry [per];
+            sh.buckets = new int32_t [buckets];
+            for (int32_t b = 0; b < buckets; b++)
+                sh.buckets[b] = -1;
+            sh.capacity = per;
+            sh.mask = buckets - 1;
+            sh.used = 0;
+            sh.head = sh.tail = -1;
+            sh.hits = sh.misses = 0;
+        }
+    }
+
+    ~SolutionCache (void) {
+        for (int s = 0; s < CACHE_SHARDS; s++) {
+            delete [] shards[s].entries;
+            delete [] shards[s].buckets;
+        }
+    }
+
+    SolutionCache (const SolutionCache &) = delete;
+    SolutionCache &operator= (const SolutionCache &) = delete;
+
+    /*  This method looks the canonical form up. An entry answers a solve
+     *  with the uniqueness check only if it was made with one. On a hit
+     *  the entry becomes the most recent, its status is returned and a
+     *  solution is copied to 'solution'; otherwise it returns -1.
+     */
+    int lookup (uint64_t hash, const uint8_t *key, bool unique, uint8_t *solution) {
+        Shard &sh = shards[hash % CACHE_SHARDS];
+        std::lock_guard<std::mutex> guard (sh.lock);
+        int32_t e = find (sh, hash, key);
+        if (e < 0 || (unique && !sh.entries[e].unique) || (!unique && sh.entries[e].status == SOLVE_MULTIPLE)) {
+            sh.misses++;
+            return -1;
+        }
+        sh.hits++;
+        unlink (sh, e);
+        pushFront (sh, e);
+        memcpy (solution, sh.entries[e].solution, 81);
+        return sh.entries[e].status;
+    }
+
+    /*  This method stores the result of a solve, replacing the entry of the
+     *  same canonical form or the least recently used one.
+     */
+    void insert (uint64_t hash, const uint8_t *key, bool unique, int status, const uint8_t *solution) {
+        Shard &sh = shards[hash % CACHE_SHARDS];
+        std::lock_guard<std::mutex> guard (sh.lock);
+        int32_t e = find (sh, hash, key);
+        if (e >= 0)
+            unlink (sh, e);
+        else {
+            if (sh.used < sh.capacity)
+                e = sh.used++;
+            else {
+                e = sh.tail;
+                unlink (sh, e);
+                unchain (sh, e);
+            }
+            Entry &n = sh.entries[e];
+            n.hash = hash;
+            memcpy (n.key, key, 81);
+            int32_t &bucket = sh.buckets[hash & sh.mask];
+            n.chain = bucket;
+            bucket = e;
+        }
+        Entry &n = sh.entries[e];
+        memcpy (n.solution, solution, 81);
+        n.status = (uint8_t) status;
+        n.unique = unique || status == SOLVE_UNSOLVABLE;
+        pushFront (sh, e);
+    }
+
+    /*  This method adds up the hits and misses of all the shards.
+     */
+    void counters (long &hits, long &misses) {
+        hits = misses = 0;
+        for (int s = 0; s < CACHE_SHARDS; s++) {
+            std::lock_guard<std::mutex> guard (shards[s].lock);
+            hits += shards[s].hits;
+            misses += shards[s].misses;
+        }
+    }
+
+    static int32_t find (Shard &sh, uint64_t hash, const uint8_t *key) {
+        for (int32_t e = sh.buckets[hash & sh.mask]; e >= 0; e = sh.entries[e].chain)
+            if (sh.entries[e].hash == hash && memcmp (sh.entries[e].key, key, 81) == 0)
+                return e;
+        return -1;
+    }
+
+    static void unlink (Shard &sh, int32_t e) {
+        Entry &n = sh.entries[e];
+        if (n.prev >= 0)
+            sh.entries[n.prev].next = n.next;
+        else
+            sh.head = n.next;
+        if (n.next >= 0)
+            sh.entries[n.next].prev = n.prev;
+        else
+            sh.tail = n.prev;
+    }
+
+    static void pushFront (Shard &sh, int32_t e) {
+        Entry &n = sh.entries[e];
+        n.prev = -1;
+        n.next = sh.head;
+        if (sh.head >= 0)
+            sh.entries[sh.head].prev = e;
+        sh.head = e;
+        if (sh.tail < 0)
+            sh.tail = e;
+    }
+
+    static void unchain (Shard &sh, int32_t e) {
+        int32_t *link = &sh.buckets[sh.entries[e].hash & sh.mask];
+        while (*link != e)
+            link = &sh.entries[*link].chain;
+        *link = sh.entries[e].chain;
+    }
+
+};
+
+/*  This function is SudokuSolver::solve () behind the cache: the puzzle is
+ *  canonicalised and looked up, and only solved on a miss. Definite results
+ *  (solved, no solution, several solutions with 'unique') are stored. A
+ *  solve cut short by the solver's limits is not. A hit leaves SS.nodes
+ *  at 0.
+ */
+inline int solveCached (SudokuSolver &SS, PuzzleCanonizer &canon, SolutionCache &cache,
+                        const SudokuSolver::Grid &in, SudokuSolver::Grid &out, bool unique = false) {
+    if (!canon.canonicalize (in))
+        return SS.solve (in, out, unique);
+    uint64_t h = canon.hash ();
+    uint8_t solution [81];
+    int status = cache.lookup (h, canon.key, unique, solution);
+    if (status >= 0) {
+        SS.nodes = 0;
+        SS.conflict = SolveConflict { -1, -1, -1, 0 };
+        if (status == SOLVE_OK)
+            canon.fromCanonical (solution, out);
+        return status;
+    }
+    status = SS.solve (in, out, unique);
+    if (status == SOLVE_OK)
+        canon.toCanonical (out, solution);
+    else
+        memset (solution, 0, sizeof (solution));
+    if (status == SOLVE_OK || status == SOLVE_UNSOLVABLE || status == SOLVE_MULTIPLE)
+        cache.insert (h, canon.key, unique, status, solution);
+    return status;
+}
+
+/*  This function is solvePuzzleLine () with solveCached (). Without a
+ *  cache, and for boards other than 9x9, it is solvePuzzleLine ().
+ */
+template <class Solver>
+inline int solveCachedLine (Solver &SS, PuzzleCanonizer *canon, SolutionCache *cache,
+                            const char *line, size_t len, char *out, bool unique = false) {
+    if constexpr (Solver::NUM == 9) {
+        if (canon != NULL && cache != NULL) {
+            SudokuSolver::Grid grid;
+            int status = SOLVE_INVALID;
+            SS.conflict = SolveConflict { -1, -1, -1, 0 };
+            if (parsePuzzleLine (line, len, grid))
+                status = solveCached (SS, *canon, *cache, grid, grid, unique);
+            if (status == SOLVE_OK) {
+                formatPuzzleLine (grid, out);
+                return status;
+            }
+            echoPuzzleLine<Solver::NUM> (line, len, out);
+            return status;
+        }
+    }
+    return solvePuzzleLine (SS, line, len, out, unique);
+}
+
+#endif
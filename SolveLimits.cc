@@ -0,0 +1,105 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   SolveLimits.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Bounds on the work of one solve: a number of search
+ *                  nodes, a wall clock time and a flag another thread can
+ *                  set to cancel. The search engines count their nodes and
+ *                  ask a SolveBudget whether to go on. The node count is
+ *                  compared on every node; the clock and the flag are only
+ *                  read every LIMIT_CHECK_NODES nodes, so a solve without
+ *                  limits pays one compare per node.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SOLVELIMITS_CC
+#define SOLVELIMITS_CC
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+
+#define LIMIT_CHECK_NODES   256     // Nodes between looks at the clock and the cancel flag
+
+/*  Limits of one solve. Zero or NULL fields do not limit anything.
+ */
+struct SolveLimits {
+    long                        maxNodes;   // Search nodes allowed
+    long                        maxMicros;  // Wall clock time allowed, from the start of the solve
+    const std::atomic<bool>    *cancel;     // Stops the solve once set
+};
+
+/*  The state of the limits during one solve.
+ */
+class SolveBudget {
+
+    public:
+
+        typedef std::chrono::steady_clock Clock;
+
+        SolveLimits         limits;         // Limits of this solve
+        Clock::time_point   deadline;       // Start of the solve plus maxMicros
+        long                nextCheck;      // Node count of the next check
+        bool                stopped;        // A limit ran out
+
+    SolveBudget (void) {
+        limits = SolveLimits { 0, 0, NULL };
+        nextCheck = LONG_MAX;
+        stopped = false;
+    }
+
+    /*  This method starts the budget of a solve. The first node checks
+     *  everything, so a solve cancelled before it starts stops at once.
+     */
+    void start (const SolveLimits &l) {
+        limits = l;
+        stopped = false;
+        if (l.maxMicros > 0)
+            deadline = Clock::now () + std::chrono::microseconds (l.maxMicros);
+        nextCheck = (l.maxNodes > 0 || l.maxMicros > 0 || l.cancel != NULL) ? 1 : LONG_MAX;
+    }
+
+    /*  This method is called by the engines with their node count after
+     *  each new node. It returns true if the search has to stop.
+     */
+    bool spent (long nodes) {
+        return nodes >= nextCheck && check (nodes);
+    }
+
+    bool check (long nodes) {
+        if (limits.maxNodes > 0 && nodes > limits.maxNodes)
+            stopped = true;
+        else if (limits.cancel != NULL && limits.cancel->load (std::memory_order_relaxed))
+            stopped = true;
+        else if (limits.maxMicros > 0 && Clock::now () >= deadline)
+            stopped = true;
+        nextCheck = nodes + LIMIT_CHECK_NODES;
+        if (limits.maxNodes > 0 && nextCheck > limits.maxNodes + 1)
+            nextCheck = limits.maxNodes + 1;
+        return stopped;
+    }
+
+};
+
+#endif
@@ -0,0 +1,601 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   SolverService.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Resident solver service. It listens on a TCP or Unix
+ *                  socket and keeps a pool of worker threads, each with
+ *                  its own warm SudokuSolver, so a request costs a solve
+ *                  and not a process start.
+ *
+ *                  The protocol has fixed size frames and no handshake. A
+ *                  request is SERVICE_REQUEST (81) bytes, one 9x9 puzzle
+ *                  in the line format of PuzzleIO.cc. A response is
+ *                  SERVICE_RESPONSE (82) bytes: the solve () status, then
+ *                  the 81 cells of the solution, or of the puzzle as it was
+ *                  sent if the status is not SOLVE_OK. A client may send
+ *                  any number of requests without waiting; they are solved
+ *                  in parallel and answered in the order they were sent.
+ *
+ *                  All the sockets are non-blocking and served by one
+ *                  event loop thread on epoll, so a connection costs a
+ *                  ServiceConnection and no thread. A connection is a
+ *                  small state machine: it reads while it has free request
+ *                  slots (a ring of SERVICE_WINDOW), stops reading while
+ *                  the ring is full, which throttles a client that sends
+ *                  faster than it reads, and is closed once the client has
+ *                  hung up and every response has gone out. The frames
+ *                  read in one pass of the loop are queued for the workers
+ *                  together.
+ *
+ *                  A worker takes up to SERVICE_BATCH queued requests at a
+ *                  time, from any connections. A batch of SERVICE_LANE_MIN
+ *                  or more goes through the LaneSolver (unless there is a
+ *                  SolutionCache), smaller ones through the scalar solver.
+ *                  Finished requests are handed back to the loop through
+ *                  an eventfd, and the loop sends the responses that are
+ *                  complete in order. Every SERVICE_REPORT_MS the loop
+ *                  prints the batch sizes and queue depths the workers met
+ *                  on stderr, if there were requests.
+ *
+ *                  Nothing is allocated per request. The jobs live in the
+ *                  slots of their connection and are chained through them
+ *                  into the queue, connections are chained into the ready
+ *                  list the same way, and closed connections are kept on a
+ *                  spare list (up to SERVICE_SPARE) for the next accept.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SOLVERSERVICE_CC
+#define SOLVERSERVICE_CC
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+#include "PuzzleIO.cc"      // One-line-per-puzzle format.
+#include "SolutionCache.cc" // Canonical form solution cache.
+#include "LaneSolver.cc"    // Lane parallel logical solver.
+
+#define SERVICE_REQUEST     81      // Bytes of a request frame
+#define SERVICE_RESPONSE    82      // Bytes of a response frame
+#define SERVICE_WINDOW      256     // Requests in flight per connection
+#define SERVICE_BATCH       LANES   // Requests a worker takes at a time
+#define SERVICE_LANE_MIN    4       // Smallest batch worth the lane solver
+#define SERVICE_REPORT_MS   10000   // Time between reports on stderr
+#define SERVICE_SPARE       1024    // Closed connections kept for reuse
+
+class ServiceConnection;
+
+/*  One request slot of a connection.
+ */
+struct ServiceJob {
+    ServiceConnection  *conn;       // Connection the request came in on
+    ServiceJob         *next;       // Next job in the pending list or the queue
+    char                request [SERVICE_REQUEST];
+    char                response [SERVICE_RESPONSE];
+};
+
+/*  The state of one client. Everything but 'done', 'flagged' and
+ *  'nextReady' belongs to the event loop thread.
+ */
+class ServiceConnection {
+
+    public:
+
+        int                 fd;             // Socket
+        uint32_t            events;         // Events registered with epoll
+        ServiceJob          slots [SERVICE_WINDOW];
+        std::atomic<bool>   done [SERVICE_WINDOW];  // Response ready, set by the workers
+        bool                flagged;        // On the ready list, under the ready lock
+        ServiceConnection  *nextReady;      // Next on the ready list, or on the spare list
+        uint32_t            received;       // Requests queued so far
+        uint32_t            sent;           // Responses moved to 'out' so far
+        bool                reading;        // Waiting for requests
+        bool                eof;            // The client will send no more
+        bool                broken;         // The socket failed, drop the responses
+        char                in [64 * SERVICE_REQUEST];      // Bytes not yet cut into frames
+        size_t              inFill;
+        char                out [SERVICE_WINDOW * SERVICE_RESPONSE];    // Responses not yet sent
+        size_t              outStart;
+        size_t              outFill;
+
+    ServiceConnection (int socket) {
+        for (int k = 0; k < SERVICE_WINDOW; k++)
+            slots[k].conn = this;
+        reset (socket);
+    }
+
+    /*  This method readies the connection for a new client on 'socket'.
+     */
+    void reset (int socket) {
+        fd = socket;
+        events = 0;
+        flagged = false;
+        nextReady = NULL;
+        received = sent = 0;
+        reading = true;
+        eof = broken = false;
+        inFill = outStart = outFill = 0;
+        for (int k = 0; k < SERVICE_WINDOW; k++)
+            done[k].store (false);
+    }
+
+};
+
+class SolverService {
+
+    public:
+
+        int                     threads;    // Worker threads
+        bool                    unique;     // Reject puzzles with several solutions
+        SolveLimits             limits;     // Limits of every solve
+        SolutionCache          *cache;      // Shared by the workers, NULL for none
+        int                     listenFd;   // Listening socket, -1 before listen ()
+        int                     epollFd;
+        int                     wakeFd;     // eventfd the workers poke when they finish
+        std::mutex              lock;       // Guards the queue
+        std::condition_variable queued;     // Signalled when jobs are queued
+        ServiceJob             *queueHead;  // Requests waiting for a worker, oldest first
+        ServiceJob             *queueTail;
+        long                    queueLength;
+        std::mutex              readyLock;  // Guards 'ready' and the 'flagged' fields
+        ServiceConnection      *ready;      // Connections with finished requests
+        ServiceJob             *pendingHead;    // Read in this pass of the loop, not queued yet
+        ServiceJob             *pendingTail;
+        long                    pendingLength;
+        ServiceConnection      *closing;    // Closed in this pass of the loop
+        ServiceConnection      *spare;      // Closed connections for reuse
+        int                     spareCount;
+        std::vector<std::thread> workers;
+        std::atomic<long>       requests;   // Requests solved
+        std::atomic<long>       batches;    // Batches taken by the workers
+        std::atomic<long>       laneBatches;    // Of those, solved in lanes
+        std::atomic<long>       depthSum;   // Queue depth seen at each take
+        std::atomic<long>       depthMax;
+
+    SolverService (int threadCount, bool uniqueCheck = false) {
+        threads = threadCount < 1 ? 1 : threadCount;
+        unique = uniqueCheck;
+        limits = SolveLimits { 0, 0, NULL };
+        cache = NULL;
+        listenFd = epollFd = wakeFd = -1;
+        queueHead = queueTail = pendingHead = pendingTail = NULL;
+        queueLength = pendingLength = 0;
+        ready = closing = spare = NULL;
+        spareCount = 0;
+        requests.store (0);
+        batches.store (0);
+        laneBatches.store (0);
+        depthSum.store (0);
+        depthMax.store (0);
+    }
+
+    /*  This method opens the listening socket. 'address' is "unix:PATH"
+     *  for a Unix socket (an old socket file at PATH is replaced),
+     *  "HOST:PORT" or just "PORT" for TCP on every interface. It returns
+     *  false if the socket cannot be set up.
+     */
+    bool listen (const char *address) {
+        if (strncmp (address, "unix:", 5) == 0) {
+            struct sockaddr_un sa;
+            memset (&sa, 0, sizeof (sa));
+            sa.sun_family = AF_UNIX;
+            if (strlen (address + 5) >= sizeof (sa.sun_path))
+                return false;
+            strcpy (sa.sun_path, address + 5);
+            unlink (sa.sun_path);
+            listenFd = socket (AF_UNIX, SOCK_STREAM, 0);
+            if (listenFd < 0 || bind (listenFd, (struct sockaddr *) &sa, sizeof (sa)) != 0)
+                return false;
+        }
+        else {
+            char host [256] = "";
+            const char *colon = strrchr (address, ':');
+            const char *port = colon ? colon + 1 : address;
+            if (colon != NULL) {
+                size_t n = colon - address;
+                if (n >= sizeof (host))
+                    return false;
+                memcpy (host, address, n);
+                host[n] = 0;
+            }
+            struct addrinfo hints, *res;
+            memset (&hints, 0, sizeof (hints));
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = AI_PASSIVE;
+            if (getaddrinfo (host[0] ? host : NULL, port, &hints, &res) != 0)
+                return false;
+            listenFd = socket (res->ai_family, res->ai_socktype, res->ai_protocol);
+            int on = 1;
+            bool bound = listenFd >= 0
+                && setsockopt (listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof (on)) == 0
+                && bind (listenFd, res->ai_addr, res->ai_addrlen) == 0;
+            freeaddrinfo (res);
+            if (!bound)
+                return false;
+        }
+        return ::listen (listenFd, 128) == 0 && fcntl (listenFd, F_SETFL, O_NONBLOCK) == 0;
+    }
+
+    /*  This method starts the workers and runs the event loop until epoll
+     *  fails. The listening socket and the eventfd are told apart from the
+     *  connections by their data pointers.
+     */
+    void run (void) {
+        epollFd = epoll_create1 (0);
+        wakeFd = eventfd (0, EFD_NONBLOCK);
+        if (epollFd < 0 || wakeFd < 0)
+            return;
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = &listenFd;
+        epoll_ctl (epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+        ev.data.ptr = &wakeFd;
+        epoll_ctl (epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+        for (int k = 0; k < threads; k++)
+            workers.push_back (std::thread (&SolverService::worker, this));
+
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point nextReport = Clock::now () + std::chrono::milliseconds (SERVICE_REPORT_MS);
+        long reported = 0, reportedBatches = 0, reportedLanes = 0, reportedDepth = 0;
+        struct epoll_event events [64];
+        while (true) {
+            int n = epoll_wait (epollFd, events, 64, SERVICE_REPORT_MS);
+            if (n < 0 && errno != EINTR)
+                return;
+            for (int k = 0; k < n; k++) {
+                void *p = events[k].data.ptr;
+                if (p == &listenFd)
+                    acceptAll ();
+                else if (p == &wakeFd)
+                    finishReady ();
+                else if (((ServiceConnection *) p)->fd >= 0) {
+                    ServiceConnection *c = (ServiceConnection *) p;
+                    if (events[k].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                        readFrames (c);
+                    if (events[k].events & EPOLLOUT)
+                        sendResponses (c);
+                    closeIfDone (c);
+                }
+            }
+            submitPending ();
+            while (closing != NULL) { // No event of this pass refers to them any more.
+                ServiceConnection *c = closing;
+                closing = c->nextReady;
+                release (c);
+            }
+
+            if (Clock::now () >= nextReport) {
+                long r = requests.load (), b = batches.load ();
+                if (b != reportedBatches)
+                    fprintf (stderr, "service: %ld requests in %ld batches, %.1f per batch, %ld batches in lanes,"
+                             " queue depth %.1f on average, %ld at most\n", r - reported, b - reportedBatches,
+                             (double) (r - reported) / (b - reportedBatches), laneBatches.load () - reportedLanes,
+                             (double) (depthSum.load () - reportedDepth) / (b - reportedBatches), depthMax.load ());
+                reported = r;
+                reportedBatches = b;
+                reportedLanes = laneBatches.load ();
+                reportedDepth = depthSum.load ();
+                depthMax.store (0);
+                nextReport = Clock::now () + std::chrono::milliseconds (SERVICE_REPORT_MS);
+            }
+        }
+    }
+
+    /*  This method accepts every waiting connection.
+     */
+    void acceptAll (void) {
+        while (true) {
+            int fd = accept (listenFd, NULL, NULL);
+            if (fd < 0)
+                return;
+            fcntl (fd, F_SETFL, O_NONBLOCK);
+            ServiceConnection *c = spare;
+            if (c != NULL) {
+                spare = c->nextReady;
+                spareCount--;
+                c->reset (fd);
+            }
+            else
+                c = new ServiceConnection (fd);
+            c->events = EPOLLIN;
+            struct epoll_event ev;
+            ev.events = c->events;
+            ev.data.ptr = c;
+            if (epoll_ctl (epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                close (fd);
+                release (c);
+            }
+        }
+    }
+
+    /*  This method cuts the input of a connection into frames while it has
+     *  free slots, reads more when the buffered bytes run out and stops on
+     *  EAGAIN, a full ring or the end of the stream.
+     */
+    void readFrames (ServiceConnection *c) {
+        while (c->reading) {
+            size_t used = 0;
+            while (c->inFill - used >= SERVICE_REQUEST && c->received - c->sent < SERVICE_WINDOW) {
+                ServiceJob *job = &c->slots[c->received++ % SERVICE_WINDOW];
+                memcpy (job->request, c->in + used, SERVICE_REQUEST);
+                job->next = NULL;
+                if (pendingTail != NULL)
+                    pendingTail->next = job;
+                else
+                    pendingHead = job;
+                pendingTail = job;
+                pendingLength++;
+                used += SERVICE_REQUEST;
+            }
+            memmove (c->in, c->in + used, c->inFill - used);
+            c->inFill -= used;
+            if (c->received - c->sent == SERVICE_WINDOW) { // Full, wait for a slot.
+                c->reading = false;
+                break;
+            }
+            ssize_t r = recv (c->fd, c->in + c->inFill, sizeof (c->in) - c->inFill, 0);
+            if (r > 0)
+                c->inFill += r;
+            else if (r < 0 && errno == EINTR)
+                continue;
+            else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            else { // End of the stream or an error; a partial frame is dropped.
+                c->eof = true;
+                c->reading = false;
+                if (r < 0)
+                    c->broken = true;
+            }
+        }
+        updateEvents (c);
+    }
+
+    /*  This method moves the responses that are complete in order to the
+     *  output buffer, as far as it has room, and sends what it can. Freed
+     *  slots let a paused connection read again.
+     */
+    void sendResponses (ServiceConnection *c) {
+        if (c->outStart == c->outFill)
+            c->outStart = c->outFill = 0;
+        else if (c->outStart > 0 && c->outFill + SERVICE_RESPONSE > sizeof (c->out)) {
+            memmove (c->out, c->out + c->outStart, c->outFill - c->outStart);
+            c->outFill -= c->outStart;
+            c->outStart = 0;
+        }
+        while (c->sent != c->received && c->done[c->sent % SERVICE_WINDOW].load (std::memory_order_acquire)) {
+            if (!c->broken && c->outFill + SERVICE_RESPONSE > sizeof (c->out))
+                break;
+            c->done[c->sent % SERVICE_WINDOW].store (false, std::memory_order_relaxed);
+            if (!c->broken) {
+                memcpy (c->out + c->outFill, c->slots[c->sent % SERVICE_WINDOW].response, SERVICE_RESPONSE);
+                c->outFill += SERVICE_RESPONSE;
+            }
+            c->sent++;
+        }
+        while (!c->broken && c->outStart < c->outFill) {
+            ssize_t w = send (c->fd, c->out + c->outStart, c->outFill - c->outStart, MSG_NOSIGNAL);
+            if (w > 0)
+                c->outStart += w;
+            else if (w < 0 && errno == EINTR)
+                continue;
+            else if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            else {
+                c->broken = c->eof = true;
+                c->reading = false;
+            }
+        }
+        if (!c->reading && !c->eof && c->received - c->sent < SERVICE_WINDOW) {
+            c->reading = true;
+            readFrames (c);
+        }
+        updateEvents (c);
+    }
+
+    /*  This method registers the events the connection waits for now.
+     */
+    void updateEvents (ServiceConnection *c) {
+        uint32_t want = (c->reading ? (uint32_t) EPOLLIN : 0u)
+                        | (!c->broken && c->outStart < c->outFill ? (uint32_t) EPOLLOUT : 0u);
+        if (want == c->events)
+            return;
+        struct epoll_event ev;
+        ev.events = want;
+        ev.data.ptr = c;
+        epoll_ctl (epollFd, EPOLL_CTL_MOD, c->fd, &ev);
+        c->events = want;
+    }
+
+    /*  This method closes a connection that is finished: no more requests,
+     *  every one answered and sent (or the socket broke), and no worker
+     *  left holding it on the ready list. The object is released at the
+     *  end of the pass, later events of the pass may still point to it.
+     */
+    void closeIfDone (ServiceConnection *c) {
+        if (c->fd < 0 || !c->eof || c->sent != c->received || (!c->broken && c->outStart < c->outFill))
+            return;
+        {
+            std::lock_guard<std::mutex> guard (readyLock);
+            if (c->flagged)
+                return;
+        }
+        epoll_ctl (epollFd, EPOLL_CTL_DEL, c->fd, NULL);
+        close (c->fd);
+        c->fd = -1;
+        c->nextReady = closing;
+        closing = c;
+    }
+
+    /*  This method puts a closed connection on the spare list, or frees it
+     *  if the list is full.
+     */
+    void release (ServiceConnection *c) {
+        if (spareCount == SERVICE_SPARE) {
+            delete c;
+            return;
+        }
+        c->nextReady = spare;
+        spare = c;
+        spareCount++;
+    }
+
+    /*  This method appends the requests read in this pass of the loop to
+     *  the queue in one go and wakes as many workers as it takes batches
+     *  to carry them.
+     */
+    void submitPending (void) {
+        if (pendingHead == NULL)
+            return;
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            if (queueTail != NULL)
+                queueTail->next = pendingHead;
+            else
+                queueHead = pendingHead;
+            queueTail = pendingTail;
+            queueLength += pendingLength;
+        }
+        if (pendingLength > SERVICE_BATCH)
+            queued.notify_all ();
+        else
+            queued.notify_one ();
+        pendingHead = pendingTail = NULL;
+        pendingLength = 0;
+    }
+
+    /*  This method sends the responses of the connections the workers
+     *  flagged since the last wake up. A connection stays flagged until
+     *  its link has been read, so a worker cannot chain it anew before.
+     */
+    void finishReady (void) {
+        uint64_t count;
+        if (read (wakeFd, &count, sizeof (count)) < 0 && errno != EAGAIN)
+            return;
+        ServiceConnection *c;
+        {
+            std::lock_guard<std::mutex> guard (readyLock);
+            c = ready;
+            ready = NULL;
+        }
+        while (c != NULL) {
+            ServiceConnection *next;
+            {
+                std::lock_guard<std::mutex> guard (readyLock);
+                next = c->nextReady;
+                c->flagged = false;
+            }
+            sendResponses (c);
+            closeIfDone (c);
+            c = next;
+        }
+    }
+
+    /*  This is the loop of one worker thread. It takes what is queued, up
+     *  to a batch, solves it and hands the connections back to the loop.
+     */
+    void worker (void) {
+        SudokuSolver SS;
+        PuzzleCanonizer *canon = cache != NULL ? new PuzzleCanonizer : NULL;
+        LaneSolver *LS = cache == NULL ? new LaneSolver : NULL;
+        SS.limits = limits;
+        if (LS != NULL)
+            LS->scalar.limits = limits;
+        ServiceJob *batch [SERVICE_BATCH];
+        const char *lines [SERVICE_BATCH];
+        uint16_t lengths [SERVICE_BATCH];
+        uint8_t status [SERVICE_BATCH];
+        char out [SERVICE_BATCH * SERVICE_RESPONSE];
+        while (true) {
+            int n = 0;
+            {
+                std::unique_lock<std::mutex> guard (lock);
+                while (queueHead == NULL)
+                    queued.wait (guard);
+                long depth = queueLength;
+                while (n < SERVICE_BATCH && queueHead != NULL) {
+                    batch[n++] = queueHead;
+                    queueHead = queueHead->next;
+                }
+                if (queueHead == NULL)
+                    queueTail = NULL;
+                queueLength -= n;
+                depthSum += depth;
+                if (depth > depthMax.load (std::memory_order_relaxed))
+                    depthMax.store (depth, std::memory_order_relaxed);
+            }
+            if (LS != NULL && n >= SERVICE_LANE_MIN) {
+                for (int k = 0; k < n; k++) {
+                    lines[k] = batch[k]->request;
+                    lengths[k] = SERVICE_REQUEST;
+                }
+                solveLaneLines (*LS, lines, lengths, n, out + 1, SERVICE_RESPONSE, status, unique);
+                for (int k = 0; k < n; k++) {
+                    out[k * SERVICE_RESPONSE] = (char) status[k];
+                    memcpy (batch[k]->response, out + k * SERVICE_RESPONSE, SERVICE_RESPONSE);
+                }
+                laneBatches++;
+            }
+            else
+                for (int k = 0; k < n; k++)
+                    batch[k]->response[0] = (char) solveCachedLine (SS, canon, cache, batch[k]->request,
+                                                                    SERVICE_REQUEST, batch[k]->response + 1, unique);
+            requests += n;
+            batches++;
+            {
+                std::lock_guard<std::mutex> guard (readyLock);
+                for (int k = 0; k < n; k++) {
+                    ServiceConnection *c = batch[k]->conn;
+                    c->done[batch[k] - c->slots].store (true, std::memory_order_release);
+                    if (!c->flagged) {
+                        c->flagged = true;
+                        c->nextReady = ready;
+                        ready = c;
+                    }
+                }
+            }
+            uint64_t one = 1;
+            if (write (wakeFd, &one, sizeof (one)) < 0)
+                continue;
+        }
+    }
+
+};
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   SolverSession.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Incremental solving for interactive play, where a board
+ *                  changes one digit at a time and every change asks
+ *                  whether the board can still be solved, and for a hint.
+ *
+ *                  A session holds the placements so far (the givens, then
+ *                  the player's digits) with their unit tags, and a stack
+ *                  of the moves. Placing or taking back a digit touches the
+ *                  three tags of its cell and nothing else. For every depth
+ *                  of the stack the session also keeps the board as the
+ *                  logical solver leaves it, so a new digit is propagated
+ *                  from the board of the depth below with placeValue () and
+ *                  propagate (), not from the givens, and an undo just goes
+ *                  back to the saved board.
+ *
+ *                  The last solution found is kept. It stays a solution of
+ *                  every board that only has fewer of the player's digits,
+ *                  so a digit that agrees with it, and any undo, is
+ *                  answered without a solve. Only a digit the kept
+ *                  solution does not have triggers a search, and that one
+ *                  starts from the propagated board.
+ *
+ *                  Nothing is allocated after the session is made. The
+ *                  stack and the saved boards are fixed arrays of CELLS
+ *                  entries, one per empty cell at most.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SOLVERSESSION_CC
+#define SOLVERSESSION_CC
+
+#include <cstring>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+
+template <int B>
+class BasicSolverSession {
+
+    public:
+
+        typedef BasicSudokuSolver<B> Solver;
+        typedef typename Solver::Board Board;
+        typedef typename Solver::Mask Mask;
+        typedef typename Solver::Grid Grid;
+        static constexpr int NUM = Solver::NUM;
+        static constexpr int CELLS = Solver::CELLS;
+
+        Solver          SS;                 // Propagates and searches for the session
+        Board           placed;             // Givens and placed digits, with their tags
+        Board           closure [CELLS + 1];    // Placed board after the logical solver, per depth
+        int8_t          result [CELLS + 1]; // Solve status of the board at each depth
+        int             moves [CELLS];      // Cells of the placed digits, in order
+        int             depth;              // Digits placed on top of the givens
+        uint8_t         solution [CELLS];   // Last solution found
+        int             solutionDepth;      // It agrees with the first solutionDepth moves, -1 if none
+        long            solves;             // Searches run, for the curious
+        SolveConflict   conflict;           // Why the last load or place was refused
+
+    BasicSolverSession (void) {
+        memset (&placed, 0, sizeof (placed));
+        depth = 0;
+        result[0] = SOLVE_INVALID;
+        solutionDepth = -1;
+        solves = 0;
+        conflict = SolveConflict { -1, -1, -1, 0 };
+    }
+
+    BasicSolverSession (const BasicSolverSession &) = delete;
+    BasicSolverSession &operator= (const BasicSolverSession &) = delete;
+
+    /*  This method starts the session on a new puzzle and returns its
+     *  status: SOLVE_INVALID if two givens clash (see 'conflict'), else
+     *  that of a full solve.
+     */
+    int load (const Grid &givens) {
+        depth = 0;
+        solutionDepth = -1;
+        if (!SS.loadPuzzle (givens)) {
+            conflict = SS.conflict;
+            memset (&placed, 0, sizeof (placed));
+            return result[0] = SOLVE_INVALID;
+        }
+        conflict = SS.conflict;
+        placed = SS.board;
+        bool consistent = SS.solveLogical ();
+        closure[0] = SS.board;
+        return result[0] = consistent ? search () : SOLVE_UNSOLVABLE;
+    }
+
+    /*  This method returns the status of the board as it stands.
+     */
+    int status (void) {
+        return result[depth];
+    }
+
+    /*  This method places n at row i, column j (from 0) and returns the
+     *  status of the new board. A digit on a full cell, out of range or on
+     *  a loaded puzzle that clashes is refused with SOLVE_INVALID and the
+     *  board stays as it was. A move that leaves no solution is kept, with
+     *  SOLVE_UNSOLVABLE, so that it can be taken back.
+     */
+    int place (int i, int j, int n) {
+        conflict = SolveConflict { -1, -1, -1, 0 };
+        if (i < 0 || i >= NUM || j < 0 || j >= NUM || n < 1 || n > NUM || result[0] == SOLVE_INVALID)
+            return SOLVE_INVALID;
+        int k = i * NUM + j;
+        if (placed.cells[k] != 0)
+            return SOLVE_INVALID;
+        if (!((candidates (k) >> (n - 1)) & 1)) {
+            conflict.cell = k;
+            conflict.value = n;
+            for (int p = 0; p < Solver::PEERS; p++)
+                if (placed.cells[Solver::geo.peers[k][p]] == n) {
+                    conflict.other = Solver::geo.peers[k][p];
+                    break;
+                }
+            return SOLVE_INVALID;
+        }
+
+        placed.cells[k] = (uint8_t) n;
+        tag (k, n, true);
+        moves[depth++] = k;
+        if (result[depth - 1] == SOLVE_UNSOLVABLE) // No digit can help a dead board.
+            return result[depth] = SOLVE_UNSOLVABLE;
+
+        const Board &below = closure[depth - 1];
+        if (below.cells[k] == n) // The logical solver had it already.
+            closure[depth] = below;
+        else {
+            SS.board = below;
+            SS.queueLen = 0;
+            SS.clearDirtyUnits ();
+            bool consistent = below.cells[k] == 0 && SS.placeValue (k, n) && SS.propagate ();
+            closure[depth] = SS.board;
+            if (!consistent)
+                return result[depth] = SOLVE_UNSOLVABLE;
+        }
+        if (solutionDepth == depth - 1 && solution[k] == n) {
+            solutionDepth = depth;
+            return result[depth] = SOLVE_OK;
+        }
+        return result[depth] = search ();
+    }
+
+    /*  This method takes back the last digit placed. It returns false if
+     *  only the givens are left.
+     */
+    bool undo (void) {
+        if (depth == 0)
+            return false;
+        int k = moves[--depth];
+        tag (k, placed.cells[k], false);
+        placed.cells[k] = 0;
+        if (solutionDepth > depth) { // A solution with more digits also solves this board.
+            solutionDepth = depth;
+            result[depth] = SOLVE_OK;
+        }
+        return true;
+    }
+
+    /*  This method suggests a digit for an empty cell: the first cell the
+     *  logical solver fills, so the hint can be found by reasoning, or else
+     *  the first empty cell, with its digit from the solution. It returns
+     *  false if the board is full or has no solution.
+     */
+    bool hint (int &i, int &j, int &n) {
+        if (result[depth] != SOLVE_OK)
+            return false;
+        int pick = -1;
+        for (int k = 0; k < CELLS && pick < 0; k++)
+            if (placed.cells[k] == 0 && closure[depth].cells[k] != 0)
+                pick = k;
+        for (int k = 0; k < CELLS && pick < 0; k++)
+            if (placed.cells[k] == 0)
+                pick = k;
+        if (pick < 0)
+            return false;
+        i = pick / NUM;
+        j = pick % NUM;
+        n = solution[pick];
+        return true;
+    }
+
+    /*  This method returns the values that still fit cell k among the
+     *  placed digits.
+     */
+    Mask candidates (int k) {
+        return ~(placed.tags[Solver::geo.cellRow[k]] | placed.tags[NUM + Solver::geo.cellCol[k]]
+                 | placed.tags[2 * NUM + Solver::geo.cellBlk[k]]) & Solver::tagFull;
+    }
+
+    /*  This method sets or clears the tags of value n in the row, column
+     *  and block of cell k, like assignTag () does on the solver's board.
+     */
+    void tag (int k, int n, bool set) {
+        Mask bit = (Mask) (1 << (n - 1));
+        Mask *t = placed.tags;
+        int u [3] = { Solver::geo.cellRow[k], NUM + Solver::geo.cellCol[k], 2 * NUM + Solver::geo.cellBlk[k] };
+        for (int m = 0; m < 3; m++)
+            t[u[m]] = set ? (Mask) (t[u[m]] | bit) : (Mask) (t[u[m]] & ~bit);
+    }
+
+    /*  This method searches the propagated board of the current depth and
+     *  keeps the solution it finds.
+     */
+    int search (void) {
+        SS.board = closure[depth];
+        solves++;
+        int found = SS.solvePuzzle (1);
+        if (SS.budget.stopped)
+            return SOLVE_BUDGET;
+        if (found == 0)
+            return SOLVE_UNSOLVABLE;
+        memcpy (solution, SS.solution, CELLS);
+        solutionDepth = depth;
+        return SOLVE_OK;
+    }
+
+};
+
+typedef BasicSolverSession<3> SolverSession;    // Session on a 9x9 board
+
+#endif
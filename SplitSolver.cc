@@ -0,0 +1,337 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   SplitSolver.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Parallel search within one puzzle, for the few grids
+ *                  (very hard ones, and unsolvable near misses above all)
+ *                  whose search tree keeps a single core busy for a long
+ *                  time. The batch pool cannot help there, it only spreads
+ *                  whole puzzles over the cores.
+ *
+ *                  A puzzle first gets an ordinary solve on the front
+ *                  solver, capped at splitNodes guesses, so the easy path
+ *                  costs what it always did. Only if that runs out is the
+ *                  search split: the front solver expands the top of the
+ *                  tree breadth first, branching on the cell with the
+ *                  fewest candidates and propagating every child, until
+ *                  there are SPLIT_FACTOR subtrees per thread (at most
+ *                  SPLIT_TASKS). The subtrees are then solved on the
+ *                  workers, each with its own warm solver.
+ *
+ *                  Nothing is locked while the subtrees are searched. A
+ *                  worker claims the next subtree with a fetch_add, adds
+ *                  its solutions to a shared atomic count and, if it found
+ *                  the first one, wins a compare-and-swap that lets it copy
+ *                  its solution out. Once the count reaches the limit a
+ *                  shared cancel flag, the SolveLimits cancel flag every
+ *                  worker solver checks, stops the other searches. Locks
+ *                  are only taken to sleep and wake the threads.
+ *
+ *                  The class has the solve () interface of the solver and
+ *                  its nodes, stats, conflict and limits fields. The time
+ *                  limit applies to the whole solve. The node limit
+ *                  applies to the plain solve and then to each subtree,
+ *                  and the cancel flag of 'limits' only to the plain solve.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SPLITSOLVER_CC
+#define SPLITSOLVER_CC
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+
+#define SPLIT_NODES     2000    // Guesses of the plain solve before the search is split
+#define SPLIT_FACTOR    8       // Subtrees per thread
+#define SPLIT_TASKS     512     // Subtrees at most
+
+template <int B>
+class BasicSplitSolver {
+
+    public:
+
+        typedef BasicSudokuSolver<B> Solver;
+        typedef typename Solver::Board Board;
+        typedef typename Solver::Mask Mask;
+        typedef typename Solver::Grid Grid;
+        static constexpr int NUM = Solver::NUM;
+        static constexpr int CELLS = Solver::CELLS;
+
+        int                     threads;        // Workers, the calling thread included
+        long                    splitNodes;     // Guesses before the search is split, 0 always splits
+        long                    nodes;          // Guesses of the last solve, on every thread
+        SolveStats              stats;          // Counters of the front solver (SUDOKU_STATS)
+        SolveLimits             limits;         // Limits of every solve
+        SolveConflict           conflict;       // Why the last puzzle failed, if it did
+        long                    splits;         // Solves that were split so far
+        Solver                  front;          // Plain solve and expansion of the tree
+        Solver                 *solvers;        // One per worker
+        Board                   tasks [SPLIT_TASKS];    // Subtrees of the split solve
+        Board                   spare [SPLIT_TASKS];    // Next level of the tree, in expand ()
+        int                     taskCount;
+        int                     limit;          // Solutions wanted
+        uint8_t                 solution [CELLS];   // First solution, written by the winner
+        std::atomic<int>        nextTask;       // Next subtree to claim
+        std::atomic<int>        found;          // Solutions counted so far
+        std::atomic<int>        winner;         // Worker that owns 'solution', -1 for none yet
+        std::atomic<long>       workerNodes;    // Guesses of the workers
+        std::atomic<bool>       cancel;         // Stops every worker solver
+        std::atomic<bool>       budgetHit;      // A solve ran out of its limits
+        long                    taskNodes;      // Node limit of each subtree
+        std::chrono::steady_clock::time_point deadline;     // End of the time limit, if there is one
+        std::mutex              lock;
+        std::condition_variable started;        // Signalled when a split solve starts
+        std::condition_variable finished;       // Signalled when a helper is done
+        unsigned                generation;     // Split solves started, under 'lock'
+        int                     busy;           // Helpers still searching, under 'lock'
+        bool                    stopping;       // Set under 'lock' by the destructor
+        std::vector<std::thread> helpers;
+
+    BasicSplitSolver (int threadCount) {
+        threads = threadCount < 1 ? 1 : threadCount;
+        splitNodes = SPLIT_NODES;
+        nodes = 0;
+        memset (&stats, 0, sizeof (stats));
+        limits = SolveLimits { 0, 0, NULL };
+        conflict = SolveConflict { -1, -1, -1, 0 };
+        splits = 0;
+        solvers = new Solver [threads];
+        taskCount = 0;
+        limit = 1;
+        generation = 0;
+        busy = 0;
+        stopping = false;
+        for (int k = 1; k < threads; k++)
+            helpers.push_back (std::thread (&BasicSplitSolver::helper, this, k));
+    }
+
+    ~BasicSplitSolver (void) {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            stopping = true;
+        }
+        started.notify_all ();
+        for (size_t k = 0; k < helpers.size (); k++)
+            helpers[k].join ();
+        delete [] solvers;
+    }
+
+    BasicSplitSolver (const BasicSplitSolver &) = delete;
+    BasicSplitSolver &operator= (const BasicSplitSolver &) = delete;
+
+    /*  This method solves the puzzle like BasicSudokuSolver::solve () and
+     *  returns the same status codes.
+     */
+    int solve (const Grid &inputMatrix, Grid &outputMatrix, bool unique = false) {
+        deadline = std::chrono::steady_clock::now () + std::chrono::microseconds (limits.maxMicros);
+        conflict = SolveConflict { -1, -1, -1, 0 };
+        limit = unique ? 2 : 1;
+        nodes = 0;
+
+        if (splitNodes > 0) {
+            SolveLimits first = limits;
+            if (first.maxNodes == 0 || first.maxNodes > splitNodes)
+                first.maxNodes = splitNodes;
+            front.limits = first;
+            int status = front.solve (inputMatrix, outputMatrix, unique);
+            nodes = front.nodes;
+            stats = front.stats;
+            conflict = front.conflict;
+            // Only a plain solve stopped by the splitNodes cap goes on in parallel.
+            if (status != SOLVE_BUDGET || first.maxNodes == limits.maxNodes || front.nodes <= first.maxNodes)
+                return status;
+        }
+
+        splits++;
+        front.limits = SolveLimits { 0, 0, NULL };
+        found.store (0);
+        winner.store (-1);
+        if (!front.loadPuzzle (inputMatrix)) {
+            conflict = front.conflict;
+            return SOLVE_INVALID;
+        }
+        if (!front.solveLogical ()) {
+            front.findDeadEnd ();
+            conflict = front.conflict;
+            return SOLVE_UNSOLVABLE;
+        }
+        expand ();
+
+        taskNodes = limits.maxNodes;
+        nextTask.store (0);
+        workerNodes.store (0);
+        cancel.store (found.load () >= limit);
+        budgetHit.store (false);
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            busy = threads - 1;
+            generation++;
+        }
+        started.notify_all ();
+        work (0);
+        {
+            std::unique_lock<std::mutex> guard (lock);
+            while (busy > 0)
+                finished.wait (guard);
+        }
+        nodes += workerNodes.load ();
+        SUDOKU_STAT (stats.nodes = nodes);
+
+        int count = found.load ();
+        if (count >= limit)
+            count = limit;
+        else if (budgetHit.load ())
+            return SOLVE_BUDGET;
+        if (count == 0)
+            return SOLVE_UNSOLVABLE;
+        if (count > 1)
+            return SOLVE_MULTIPLE;
+        for (int j = 0; j < NUM; j++)
+            for (int k = 0; k < NUM; k++)
+                outputMatrix [j][k] = solution [j * NUM + k];
+        return SOLVE_OK;
+    }
+
+    /*  This method expands the front solver's board breadth first into
+     *  'tasks', one level of the tree at a time, while the next level
+     *  fits and there are fewer than SPLIT_FACTOR subtrees per thread.
+     *  Children that propagate to a dead end are dropped and full boards
+     *  are counted as solutions on the spot. Every child counts as a node.
+     */
+    void expand (void) {
+        int target = SPLIT_FACTOR * threads;
+        if (target > SPLIT_TASKS)
+            target = SPLIT_TASKS;
+        tasks[0] = front.board;
+        taskCount = 1;
+        while (taskCount > 0 && taskCount < target) {
+            int grown = 0, k = 0;
+            for (; k < taskCount; k++) { // Expand in place, the unexpanded rest moves up.
+                Board parent = tasks[k];
+                front.board = parent;
+                Mask cand;
+                int cell = front.selectCell (cand);
+                if (cell == SELECT_SOLVED) {
+                    countSolution (front.board.cells, 1, 0);
+                    continue;
+                }
+                if (cell == SELECT_DEAD)
+                    continue;
+                if (grown + (taskCount - k - 1) + __builtin_popcount (cand) > SPLIT_TASKS)
+                    break;
+                for (; cand; cand &= cand - 1) {
+                    front.board = parent;
+                    front.queueLen = 0;
+                    front.clearDirtyUnits ();
+                    nodes++;
+                    if (front.placeValue (cell, __builtin_ctz (cand) + 1) && front.propagate ())
+                        spare[grown++] = front.board;
+                }
+            }
+            if (k < taskCount) { // No room for a whole level, keep what is left as it is.
+                for (; k < taskCount; k++)
+                    spare[grown++] = tasks[k];
+                memcpy (tasks, spare, grown * sizeof (Board));
+                taskCount = grown;
+                return;
+            }
+            memcpy (tasks, spare, grown * sizeof (Board));
+            taskCount = grown;
+        }
+    }
+
+    /*  This method adds n solutions of worker id to the shared count. The
+     *  first worker to get here copies its solution out, the one that
+     *  reaches the limit cancels the other searches.
+     */
+    void countSolution (const uint8_t *cells, int n, int id) {
+        int expected = -1;
+        if (winner.compare_exchange_strong (expected, id, std::memory_order_acq_rel))
+            memcpy (solution, cells, CELLS);
+        if (found.fetch_add (n, std::memory_order_acq_rel) + n >= limit)
+            cancel.store (true, std::memory_order_relaxed);
+    }
+
+    /*  This method claims subtrees and searches them on worker id's solver
+     *  until none are left or the solve is cancelled.
+     */
+    void work (int id) {
+        Solver &S = solvers[id];
+        long spent = 0;
+        while (!cancel.load (std::memory_order_relaxed)) {
+            int t = nextTask.fetch_add (1, std::memory_order_relaxed);
+            if (t >= taskCount)
+                break;
+            long micros = 0;
+            if (limits.maxMicros > 0) { // What is left of the time of the whole solve.
+                micros = std::chrono::duration_cast<std::chrono::microseconds> (deadline - std::chrono::steady_clock::now ()).count ();
+                if (micros < 1)
+                    micros = 1;
+            }
+            S.limits = SolveLimits { taskNodes, micros, &cancel };
+            S.board = tasks[t];
+            int n = S.solvePuzzle (limit);
+            spent += S.nodes;
+            if (n > 0)
+                countSolution (S.solution, n, id);
+            if (S.budget.stopped && !cancel.load (std::memory_order_relaxed)) { // A limit ran out, not the count.
+                budgetHit.store (true, std::memory_order_relaxed);
+                cancel.store (true, std::memory_order_relaxed);
+            }
+        }
+        workerNodes.fetch_add (spent, std::memory_order_relaxed);
+    }
+
+    /*  This is the loop of one helper thread: it joins every split solve
+     *  and reports back when it runs out of subtrees.
+     */
+    void helper (int id) {
+        unsigned seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard (lock);
+                while (!stopping && generation == seen)
+                    started.wait (guard);
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+            work (id);
+            {
+                std::lock_guard<std::mutex> guard (lock);
+                busy--;
+            }
+            finished.notify_one ();
+        }
+    }
+
+};
+
+#endif
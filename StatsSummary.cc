@@ -0,0 +1,134 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   StatsSummary.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Adds up the SolveStats of many solves. Besides the totals
+ *                  it keeps power-of-two histograms of the search nodes and
+ *                  of the solve time per puzzle, which show the puzzle
+ *                  classes that are slow. Each thread keeps its own summary
+ *                  and they are merged at the end. The counters are only
+ *                  filled in builds with -DSUDOKU_STATS.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+#ifndef STATSSUMMARY_CC
+#define STATSSUMMARY_CC
+
+#include <cstdio>
+#include <cstring>
+#include "SudokuSolver.cc"  // The SolveStats counters.
+
+#define STATS_BINS  24      // Histogram bins: 0, 1, 2-3, 4-7, ...
+
+class StatsSummary {
+
+    public:
+
+        long    puzzles;                // Solves added
+        long    logicalOnly;            // Solves that needed no guess
+        long    logicalCells;           // Totals of the SolveStats fields
+        long    searchCells;
+        long    nodes;
+        long    backtracks;
+        long    checks;
+        int     maxDepth;               // Deepest search of all solves
+        double  logicalMicros;
+        double  searchMicros;
+        long    nodeHist [STATS_BINS];  // Solves per bin of search nodes
+        long    timeHist [STATS_BINS];  // Solves per bin of microseconds
+
+    StatsSummary (void) {
+        memset (this, 0, sizeof (*this));
+    }
+
+    /*  This method returns the histogram bin of x: 0 for x < 1, otherwise
+     *  1 + floor (log2 (x)), capped at the last bin.
+     */
+    static int bin (double x) {
+        if (x < 1)
+            return 0;
+        int b = 64 - __builtin_clzll ((unsigned long long) x);
+        return b < STATS_BINS ? b : STATS_BINS - 1;
+    }
+
+    void add (const SolveStats &s) {
+        puzzles++;
+        logicalOnly += s.nodes == 0;
+        logicalCells += s.logicalCells;
+        searchCells += s.searchCells;
+        nodes += s.nodes;
+        backtracks += s.backtracks;
+        checks += s.checks;
+        maxDepth = s.maxDepth > maxDepth ? s.maxDepth : maxDepth;
+        logicalMicros += s.logicalMicros;
+        searchMicros += s.searchMicros;
+        nodeHist[bin (s.nodes)]++;
+        timeHist[bin (s.logicalMicros + s.searchMicros)]++;
+    }
+
+    void merge (const StatsSummary &o) {
+        puzzles += o.puzzles;
+        logicalOnly += o.logicalOnly;
+        logicalCells += o.logicalCells;
+        searchCells += o.searchCells;
+        nodes += o.nodes;
+        backtracks += o.backtracks;
+        checks += o.checks;
+        maxDepth = o.maxDepth > maxDepth ? o.maxDepth : maxDepth;
+        logicalMicros += o.logicalMicros;
+        searchMicros += o.searchMicros;
+        for (int b = 0; b < STATS_BINS; b++) {
+            nodeHist[b] += o.nodeHist[b];
+            timeHist[b] += o.timeHist[b];
+        }
+    }
+
+    /*  This method prints the totals and both histograms.
+     */
+    void print (FILE *out) {
+        double n = puzzles > 0 ? puzzles : 1;
+        fprintf (out, "Solve statistics: %ld puzzles, %ld solved without search\n", puzzles, logicalOnly);
+        fprintf (out, "  per puzzle: %.1f cells logical, %.1f cells in search, %.1f nodes, %.1f backtracks, %.0f checks\n",
+                 logicalCells / n, searchCells / n, nodes / n, backtracks / n, checks / n);
+        fprintf (out, "  per puzzle: %.2f us logical, %.2f us search, max search depth %d\n",
+                 logicalMicros / n, searchMicros / n, maxDepth);
+        printHistogram (out, "nodes", nodeHist);
+        printHistogram (out, "microseconds", timeHist);
+    }
+
+    void printHistogram (FILE *out, const char *what, const long *hist) {
+        fprintf (out, "  %s per puzzle:\n", what);
+        for (int b = 0; b < STATS_BINS; b++) {
+            if (hist[b] == 0)
+                continue;
+            if (b == 0)
+                fprintf (out, "    %10s  %ld\n", "< 1", hist[b]);
+            else
+                fprintf (out, "    %10lld+ %ld\n", 1LL << (b - 1), hist[b]);
+        }
+    }
+
+};
+
+#endif
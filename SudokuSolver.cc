@@ -8,16 +8,17 @@
  *
  *  Version     :   2.0.0
  *  Created     :   10/11/2009
- *  Modified    :   12/06/2011
+ *  Modified    :   10/14/2026
  *
- *  Description :   This class solves SuDoKu puzzles. It receives a 2D array
- *                  during initialization (via constructor). The empty cells
- *                  in the puzzle can have any random value. The class will
+ *  Description :   This class solves SuDoKu puzzles. One object can be
+ *                  reused for any number of puzzles. Each call to solve()
+ *                  receives a 2D array with the puzzle. The empty cells in
+ *                  the puzzle can have any random value. The class will
  *                  ignore them while reading the input.
  *
- *                  The constructor itself calls the initialization methods
- *                  followed by the solvers and finally writes the input array
- *                  (using a reference call - does not return anything).
+ *                  solve() loads the puzzle, runs the solvers and writes the
+ *                  result to the output array. It returns a status code
+ *                  instead of exiting, and it does not print or allocate.
  *
  *  License     :   This program is free software: you can redistribute it and/or modify
  *                  it under the terms of the GNU General Public License as published by
@@ -35,89 +36,414 @@
  *  Changelog   :
  *      12/06/2011  :   Added license.
  *                      Cleaned up the code.
+ *      10/14/2026  :   Tags are now one 9-bit mask per row, column and
+ *                      block. Backtracker walks the candidate bits.
+ *                      Replaced the solving constructor with a reusable
+ *                      solve() call that returns a status code.
+ *                      Rewrote the logical solver around a naked single
+ *                      queue and a dirty unit mask. It now finds hidden
+ *                      singles of every value, including 9.
+ *                      Backtracker picks the cell with the fewest
+ *                      candidates and propagates singles after each guess.
+ *                      Backtracker is iterative, with a fixed search stack.
+ *                      Added countSolutions() and the unique mode of solve().
+ *                      Added SolveStats counters behind SUDOKU_STATS.
+ *                      Templated on the block size (BasicSudokuSolver<B>)
+ *                      with compile time geometry; SudokuSolver is the 9x9
+ *                      instance.
+ *                      Cell, unit and peer lookup tables (SudokuGeometry)
+ *                      built at compile time replace the index arithmetic
+ *                      of the inner loops.
+ *                      The board is one flat Board of byte cells and unit
+ *                      tags; the search restores a saved copy per guess
+ *                      instead of undoing a trail.
+ *                      9x9 boards pick the branching cell and seed the
+ *                      singles with the SIMD kernel of CandidateKernel.cc.
+ *                      Added the Dancing Links search (DancingLinks.cc) as a
+ *                      second engine, picked with setEngine().
+ *                      Added the clause learning engine (ConflictSolver.cc).
+ *                      The backtracker hands a puzzle over to it once the
+ *                      search passes handoverNodes guesses.
+ *                      Solves are bounded by SolveLimits (nodes, time and a
+ *                      cancel flag) and return SOLVE_BUDGET when cut short.
+ *                      Failed puzzles record where they went wrong in
+ *                      'conflict': the clashing givens, or the cell or unit
+ *                      the logical solver found dead.
+ *                      printPuzzle() writes the board in one go, without
+ *                      a flush per row.
+ *                      The technique passes of TechniqueRater.cc can run
+ *                      after the logical solver, see 'techniques'.
  *
  ******************************************************************************
  */
 
+#ifndef SUDOKUSOLVER_CC
+#define SUDOKUSOLVER_CC
+
 #include <iostream>
 #include <cstdio>
 #include <cstring>
+#include <string>
+#include <stdint.h>
+#include <type_traits>
+#include <cstddef>
+#ifdef SUDOKU_STATS
+#include <chrono>
+#endif
+#include "CandidateKernel.cc"   // Whole board candidate scan for 9x9.
+#include "SolveLimits.cc"       // Node, time and cancel limits.
+#include "DancingLinks.cc"      // Exact cover search engine.
+#include "ConflictSolver.cc"    // Clause learning search engine.
+#include "TechniqueRater.cc"    // Human style technique passes.
 
 using namespace std;
 
-class SudokuSolver {
+/*  Build with -DSUDOKU_STATS to fill BasicSudokuSolver::stats. Without it every
+ *  SUDOKU_STAT statement compiles to nothing and the counters cost nothing.
+ */
+#ifdef SUDOKU_STATS
+#define SUDOKU_STAT(...)    __VA_ARGS__
+#else
+#define SUDOKU_STAT(...)
+#endif
+
+/*  Return codes of BasicSudokuSolver::solve().
+ */
+enum SolveStatus {
+    SOLVE_OK = 0,       // Puzzle solved, output holds the solution
+    SOLVE_UNSOLVABLE,   // Givens are consistent but the puzzle has no solution
+    SOLVE_INVALID,      // Two givens clash in a row, column or block
+    SOLVE_MULTIPLE,     // Puzzle has more than one solution
+    SOLVE_BUDGET        // A solve limit ran out first, see SolveLimits
+};
+
+/*  Search engines of BasicSudokuSolver::setEngine(). All of them run after
+ *  the logical solver and count the same solutions; they differ in speed
+ *  per puzzle class.
+ */
+enum SolveEngine {
+    ENGINE_TAGS = 0,    // Tag based backtracker, solveBacktrack()
+    ENGINE_DLX,         // Dancing Links exact cover, BasicDancingLinks
+    ENGINE_CDCL         // Clause learning, BasicConflictSolver
+};
+
+#define HANDOVER_NODES  10000   // Default of BasicSudokuSolver::handoverNodes
+
+/*  Counters of one solve, see SUDOKU_STATS. They stay zero in normal builds.
+ */
+struct SolveStats {
+    long    logicalCells;       // Cells filled by solveLogical ()
+    long    searchCells;        // Cells filled during the search, undone ones included
+    long    nodes;              // Guesses made by the search
+    long    backtracks;         // Guesses taken back
+    int     maxDepth;           // Deepest search stack
+    long    checks;             // Candidate mask lookups
+    double  logicalMicros;      // Time in solveLogical ()
+    double  searchMicros;       // Time in solveBacktrack ()
+};
+
+/*  Where a puzzle failed, for SOLVE_INVALID and for SOLVE_UNSOLVABLE found
+ *  by the logical solver. Fields that do not apply are -1 (0 for 'value').
+ */
+struct SolveConflict {
+    int     cell;       // Clashing given, or empty cell left without a candidate
+    int     other;      // Earlier given of the same value in a unit of 'cell'
+    int     unit;       // Unit where 'value' has no place left
+    int     value;      // Value of the clash, or the value without a place
+};
+
+#define SELECT_SOLVED   -1  // selectCell(): no empty cell left
+#define SELECT_DEAD     -2  // selectCell(): an empty cell has no candidate
+#define SEARCH_HANDOVER -1  // solveBacktrack(): node budget spent, nothing counted
+
+/*  Lookup tables of the board geometry for block size B, filled in at
+ *  compile time. Cells are numbered i * NUM + j and units as in the solver:
+ *  the NUM rows, then the NUM columns, then the NUM blocks. With these the
+ *  solver's inner loops never divide to find the row, column, block or
+ *  peers of a cell. The entries are bytes up to 16x16 boards.
+ */
+template <int B>
+struct SudokuGeometry {
+
+    static constexpr int NUM = B * B;                   // Cells per unit
+    static constexpr int ROW = B;                       // Rows and columns of a block
+    static constexpr int CELLS = NUM * NUM;             // Cells of the board
+    static constexpr int UNITS = 3 * NUM;               // Rows, columns and blocks
+    static constexpr int PEERS = 3 * NUM - 2 * B - 1;   // Cells that share a unit with a cell
+
+    typedef typename conditional<(CELLS <= 256), uint8_t, uint16_t>::type Index;
+
+    Index   cellRow [CELLS];            // Row of each cell
+    Index   cellCol [CELLS];            // Column of each cell
+    Index   cellBlk [CELLS];            // Block of each cell
+    Index   unitCells [UNITS][NUM];     // Cells of each unit, in order
+    Index   peers [CELLS][PEERS];       // Row, column and block peers of each cell
+
+    constexpr SudokuGeometry (void) : cellRow (), cellCol (), cellBlk (), unitCells (), peers () {
+        for (int i = 0; i < NUM; i++)
+            for (int j = 0; j < NUM; j++) {
+                int k = i * NUM + j, b = (i / B) * B + j / B;
+                cellRow[k] = (Index) i;
+                cellCol[k] = (Index) j;
+                cellBlk[k] = (Index) b;
+                unitCells[i][j] = (Index) k;
+                unitCells[NUM + j][i] = (Index) k;
+                unitCells[2 * NUM + b][(i % B) * B + j % B] = (Index) k;
+
+                int cnt = 0, bi = (i / B) * B, bj = (j / B) * B;
+                for (int n = 0; n < NUM; n++) {
+                    int p = bi + n / B, q = bj + n % B;
+                    if (n != j)
+                        peers[k][cnt++] = (Index) (i * NUM + n);
+                    if (n != i)
+                        peers[k][cnt++] = (Index) (n * NUM + j);
+                    if (p != i && q != j)
+                        peers[k][cnt++] = (Index) (p * NUM + q);
+                }
+            }
+    }
+};
+
+/*  The solver is a template on the block size B: B = 3 is the classic 9x9
+ *  puzzle, 4 and 5 solve 16x16 and 25x25 grids. All the geometry is a
+ *  compile time constant, so every size gets its own hot loops with the
+ *  block index arithmetic folded, and the value masks are only as wide as
+ *  they need to be.
+ */
+template <int B>
+class BasicSudokuSolver {
+
+    static_assert (B >= 2 && B <= 5, "the value masks hold at most 32 values");
 
     public:
 
-        int     NUM;                    // Constant 9
-        int     ROW;                    // Constant 3
-        int     COL;                    // Constant 3
-        int     BLK;                    // Constant 3
-        int     problemMatrix [9][9];   // Main problem matrix
-        bool    tagRow [9][9];          // Row tags
-        bool    tagCol [9][9];          // Column tags
-        bool    tagBlk [9][9];          // Block tags
-
-    SudokuSolver (int (&inputMatrix) [9][9]) {
-        NUM = 9;
-        ROW = 3;
-        COL = 3;
-        BLK = 3;
+        static constexpr int NUM = B * B;           // Values, and cells per unit
+        static constexpr int ROW = B;               // Rows of a block
+        static constexpr int COL = B;               // Columns of a block
+        static constexpr int BLK = B;               // Blocks per band
+        static constexpr int CELLS = NUM * NUM;     // Cells of the board
+        static constexpr int UNITS = 3 * NUM;       // Rows, columns and blocks
+        static constexpr int UNIT_WORDS = (UNITS + 63) / 64;
+
+        typedef typename conditional<(NUM <= 16), uint16_t, uint32_t>::type Mask;
+        typedef int Grid [NUM][NUM];                // Puzzle as passed in and out
+        typedef SudokuGeometry<B> Geometry;
+        typedef typename Geometry::Index Index;
+
+        static constexpr int PEERS = Geometry::PEERS;
+        static constexpr Geometry geo = Geometry (); // Cell, unit and peer tables
+
+        static constexpr Mask tagFull = (Mask) ((1ull << NUM) - 1); // All NUM value bits set
+
+        /*  The whole state of a puzzle being solved: one byte per cell,
+         *  flat in cell order, followed by the tags of the UNITS units (bit
+         *  n-1 of a tag is set once n is placed in the unit). For 9x9 it is
+         *  81 + 54 bytes, three cache lines, and copying it is a handful of
+         *  vector moves, so the search saves a copy per guess instead of
+         *  undoing the assignments one by one.
+         */
+        struct alignas (64) Board {
+            uint8_t     cells [CELLS];      // Value of each cell, 0 if empty
+            Mask        tags [UNITS];       // Row, then column, then block tags
+        };
+
+        /*  One open branching cell of the search.
+         */
+        struct SearchFrame {
+            int         cell;               // i * NUM + j of the cell
+            Mask        remaining;          // Candidates not tried yet
+        };
+
+        Board       board;                  // Main problem board
+        Board       saved [CELLS];          // Board before the guess at each search depth
+        uint8_t     solution [CELLS];       // First solution found by the search
+        uint64_t    dirtyUnits [UNIT_WORDS];    // Units to scan for hidden singles
+        int         singleQueue [CELLS];    // Cells left with one candidate
+        int         queueLen;               // Entries in singleQueue
+        SearchFrame searchStack [CELLS];    // Open cells of the search
+        long        nodes;                  // Guesses made by the last solve
+        SolveStats  stats;                  // Counters of the last solve (SUDOKU_STATS)
+        SolveLimits limits;                 // Limits of every solve, none by default
+        SolveBudget budget;                 // Limits of the solve in progress
+        SolveConflict conflict;             // Why the last puzzle failed, if it did
+        int         engine;                 // SolveEngine of the search
+        long        handoverNodes;          // Backtracker guesses before ENGINE_CDCL takes over, 0 never
+        BasicDancingLinks<B> *links;        // Exact cover matrix, made on first use
+        BasicConflictSolver<Geometry> *learner; // Clause learning engine, made on first use
+        int         techniques;             // TechniqueTier passes after the logical solver, 0 for none
+        BasicTechniqueRater<Geometry> *rater;   // Runs them, made on first use
+
+    BasicSudokuSolver (void) {
+        nodes = 0;
+        engine = ENGINE_TAGS;
+        handoverNodes = HANDOVER_NODES;
+        links = NULL;
+        learner = NULL;
+        techniques = 0;
+        rater = NULL;
+        queueLen = 0;
+        clearDirtyUnits ();
+        memset (&stats, 0, sizeof (stats));
+        limits = SolveLimits { 0, 0, NULL };
         initTag ();
         initPuzzle ();
+    }
+
+    ~BasicSudokuSolver () {
+        delete links;
+        delete learner;
+        delete rater;
+    }
+
+    BasicSudokuSolver (const BasicSudokuSolver &) = delete;
+    BasicSudokuSolver &operator= (const BasicSudokuSolver &) = delete;
+
+    /*  This method selects the search engine of the following solves. The
+     *  Dancing Links matrix is built the first time ENGINE_DLX is selected
+     *  and then kept, its nodes are reused for every puzzle. The clause
+     *  learning engine is kept the same way.
+     */
+    void setEngine (int e) {
+        engine = (e == ENGINE_DLX || e == ENGINE_CDCL) ? e : ENGINE_TAGS;
+        if (engine == ENGINE_DLX && links == NULL)
+            links = new BasicDancingLinks<B>;
+        if (engine == ENGINE_CDCL && learner == NULL)
+            learner = new BasicConflictSolver<Geometry>;
+    }
+
+    /*  This is the entry point of the class. It reads the puzzle from the
+     *  input matrix, solves it and copies the result to the output matrix.
+     *  Input and output may be the same array. The output is only written
+     *  when SOLVE_OK is returned.
+     *
+     *  With 'unique' set the search goes on after the first solution until a
+     *  second one turns up, and SOLVE_MULTIPLE is returned if it does. That
+     *  costs about one more pass over the search tree, not an enumeration.
+     *
+     *  The search stops early with SOLVE_BUDGET if one of 'limits' runs out;
+     *  'nodes' and 'stats' then describe the work done up to that point.
+     *
+     *  The object keeps no state between calls, so the same instance can be
+     *  used for one puzzle after the other.
+     */
+    int solve (const Grid &inputMatrix, Grid &outputMatrix, bool unique = false) {
+        if (!loadPuzzle (inputMatrix))
+            return SOLVE_INVALID;
+        int found = solvePuzzle (unique ? 2 : 1);
+        if (budget.stopped)
+            return SOLVE_BUDGET;
+        if (found == 0)
+            return SOLVE_UNSOLVABLE;
+        if (found > 1)
+            return SOLVE_MULTIPLE;
+        for (int j = 0; j < NUM; j++)
+            for (int k = 0; k < NUM; k++)
+                outputMatrix [j][k] = solution [j * NUM + k];
+        return SOLVE_OK;
+    }
+
+    /*  This method counts the solutions of the puzzle, stopping as soon as
+     *  'limit' of them are found, so countSolutions (in, 2) is the usual
+     *  uniqueness check. Clashing givens count as no solution. The first
+     *  solution found is left in 'solution'. It returns -1 if one of
+     *  'limits' ran out before the count was known.
+     */
+    int countSolutions (const Grid &inputMatrix, int limit) {
+        if (!loadPuzzle (inputMatrix))
+            return 0;
+        int found = solvePuzzle (limit);
+        return budget.stopped ? -1 : found;
+    }
+
+    /*  This method copies the givens of the input matrix onto the board
+     *  and sets the tags. Values outside 1..NUM are empty cells. It returns
+     *  false if two givens clash, and 'conflict' names them.
+     */
+    bool loadPuzzle (const Grid &inputMatrix) {
+        conflict = SolveConflict { -1, -1, -1, 0 };
         for (int j = 0; j < NUM; j++)
             for (int k = 0; k < NUM; k++) {
                 if (inputMatrix[j][k] < 1 || inputMatrix[j][k] > NUM)
-                    continue;
+                    board.cells [j * NUM + k] = 0;
                 else
-                    problemMatrix [j][k] = inputMatrix [j][k];
+                    board.cells [j * NUM + k] = (uint8_t) inputMatrix [j][k];
             }
-        fillTags();
-        if (solvePuzzle ()) {
-            for (int j = 0; j < NUM; j++)
-                for (int k = 0; k < NUM; k++)
-                    inputMatrix [j][k] = problemMatrix [j][k];
-        }
-        else {
-            cerr << "Error: Puzzle cannot  be solved." << endl;
-            exit (1);
-        }
+        return fillTags ();
     }
 
-    /*  This function initializes all the tags to false (as in empty). The tags
-     *  are later used to determine if a number is valid in a row, column or
-     *  block. Whenever the number is filled, the corresponding tags are set.
+    /*  This function clears all the tags (as in empty). The tags are later
+     *  used to determine if a number is valid in a row, column or block. Each
+     *  row, column and block has one mask; bit n-1 of the mask is set once
+     *  the number n is filled in that unit.
      */
     void initTag (void) {
-        for (int j = 0; j < NUM; j++) {
-            for (int k = 0; k < NUM; k++) {
-                tagRow[j][k] = false;
-                tagCol[j][k] = false;
-                tagBlk[j][k] = false;
-            }
-        }
+        for (int u = 0; u < UNITS; u++)
+            board.tags[u] = 0;
     }
 
-    /*  This function makes all the cells of the main problem matrix zero.
-     *  It is not really required if the input to the class already has
-     *  zeroes in place instead of empty / garbage cells.
+    /*  This function makes all the cells of the board zero. It is not
+     *  really required if the input to the class already has zeroes in
+     *  place instead of empty / garbage cells.
      */
     void initPuzzle (void) {
-        for (int j = 0; j < NUM; j++) {
-            for (int k = 0; k < NUM; k++) {
-                problemMatrix   [j][k]  = 0;
-            }
-        }
+        memset (board.cells, 0, sizeof (board.cells));
     }
 
     /*  After reading the input puzzle, call this function. This function
-     *  goes through the problem matrix and calls the assignTag method that
-     *  sets the proper tags to true.
+     *  clears the tags, then goes through the board and calls the assignTag
+     *  method that sets the proper tags. It returns false if a given is
+     *  already tagged in its row, column or block. One pass over the cells
+     *  and three mask reads per given, so a bad puzzle never gets to the
+     *  search.
      */
-    void fillTags (void) {
+    bool fillTags (void) {
+        initTag ();
         for (int i = 0; i < NUM; i++)
-            for (int j = 0; j < NUM; j++)
-                assignTag (i, j, problemMatrix[i][j]);
+            for (int j = 0; j < NUM; j++) {
+                int n = board.cells[i * NUM + j];
+                if (n > 0 && !checkValid (i, j, n)) {
+                    findClash (i * NUM + j, n);
+                    return false;
+                }
+                assignTag (i, j, n);
+            }
+        return true;
+    }
+
+    /*  This method records the clash of the given n at cell k with the
+     *  earlier given that set the tag.
+     */
+    void findClash (int k, int n) {
+        conflict = SolveConflict { k, -1, -1, n };
+        for (int p = 0; p < PEERS; p++) {
+            int q = geo.peers[k][p];
+            if (q < k && board.cells[q] == n && (conflict.other < 0 || q < conflict.other))
+                conflict.other = q;
+        }
+    }
+
+    /*  This method is called when the logical solver hits a contradiction.
+     *  It records an empty cell without a candidate or, failing that, a
+     *  unit with a value that has no place left.
+     */
+    void findDeadEnd (void) {
+        for (int k = 0; k < CELLS; k++)
+            if (cellValue (k) == 0 && cellCandidates (k) == 0) {
+                conflict.cell = k;
+                return;
+            }
+        for (int u = 0; u < UNITS; u++) {
+            Mask open = 0;
+            for (int n = 0; n < NUM; n++)
+                if (cellValue (geo.unitCells[u][n]) == 0)
+                    open |= cellCandidates (geo.unitCells[u][n]);
+            Mask missing = (Mask) (tagFull & ~(open | unitTag (u)));
+            if (missing) {
+                conflict.unit = u;
+                conflict.value = __builtin_ctz (missing) + 1;
+                return;
+            }
+        }
     }
 
     /*  This function checks if the input value 'c' can be placed inside the
@@ -127,14 +453,30 @@ class SudokuSolver {
      *  row, column or the block then it is valid and method returns true.
      */
     bool checkValid (int i, int j, int c) {
-        c--;
-        if (tagRow[i][c] == true)
-            return false;
-        if (tagCol[c][j] == true)
-            return false;
-        if (tagBlk[(i/BLK)*BLK+j/BLK][c] == true)
-            return false;
-        return true;
+        return (candidates (i, j) >> (c - 1)) & 1;
+    }
+
+    /*  This function returns the mask of all the values that can still be
+     *  placed at [i][j]. It is the complement of the row, column and block
+     *  tags of the cell, so bit n-1 is set if the value n is valid there.
+     */
+    Mask candidates (int i, int j) {
+        return cellCandidates (i * NUM + j);
+    }
+
+    /*  Same as candidates () for the cell numbered k = i * NUM + j. The
+     *  solver's own loops work on cell numbers and these table lookups.
+     */
+    Mask cellCandidates (int k) {
+        SUDOKU_STAT (stats.checks++);
+        return ~(board.tags[geo.cellRow[k]] | board.tags[NUM + geo.cellCol[k]]
+                 | board.tags[2 * NUM + geo.cellBlk[k]]) & tagFull;
+    }
+
+    /*  This method returns the board entry of cell k.
+     */
+    uint8_t &cellValue (int k) {
+        return board.cells[k];
     }
 
     /*  This method is used to set the tags to true. Once it's determined that
@@ -144,131 +486,244 @@ class SudokuSolver {
     void assignTag (int i, int j, int n) {
         if (n == 0)
             return;
-        n--;
-        tagRow[i][n] = true;
-        tagCol[n][j] = true;
-        tagBlk[(i/BLK)*BLK+j/BLK][n] = true;
-    }
-
-    /*  This method is used for the backtracking. Once the logical solving is
-     *  done the class goes into backtracking mode. It sets a random valid value
-     *  and tries to solve the puzzle. If it gives an error, the solver needs to
-     *  go back (backtrack). This also means it needs to reset the tags which
-     *  were set during the initial backtrack assumption.
-     */
-    void resetTag (int i, int j, int n) {
-        if (n == 0)
-            return;
-        n--;
-        tagRow[i][n] = false;
-        tagCol[n][j] = false;
-        tagBlk[(i/BLK)*BLK+j/BLK][n] = false;
+        Mask bit = 1 << (n - 1);
+        board.tags[i] |= bit;
+        board.tags[NUM + j] |= bit;
+        board.tags[2 * NUM + geo.cellBlk[i * NUM + j]] |= bit;
     }
 
     /*  This method is just a placeholder for different solving mechanisms. The
      *  puzzles can have various difficulties and solver may need more methods.
-     *  Those algorithms would be called through this method. Mainly for future
-     *  use.
+     *  Those algorithms would be called through this method. The logical
+     *  solver always runs first; the selected engine searches what is left.
+     *
+     *  The backtracker is fast on almost every puzzle but has a long tail:
+     *  a few grids, unsolvable near misses most of all, take it millions of
+     *  guesses. When it passes handoverNodes guesses the board is put back
+     *  as the logical solver left it and clause learning starts over on it,
+     *  which caps those tails at the cost of the guesses spent so far.
+     *
+     *  With 'techniques' set, the passes of TechniqueRater.cc take over
+     *  where the singles stall, and the digits they find are placed before
+     *  the search, which then often has nothing left to do. They only place
+     *  digits every solution has, so the count does not change, but a
+     *  puzzle with several solutions may report a different first one.
      */
-    bool solvePuzzle(void) {
-        solveLogical ();
+    int solvePuzzle(int limit) {
+        nodes = 0;
+        budget.start (limits);
+        SUDOKU_STAT (memset (&stats, 0, sizeof (stats)));
+        SUDOKU_STAT (double t0 = statClock ());
+        bool consistent = solveLogical () && (techniques == 0 || solveTechniques ());
+        SUDOKU_STAT (stats.logicalCells = stats.searchCells);
+        SUDOKU_STAT (double t1 = statClock ());
+        SUDOKU_STAT (stats.logicalMicros = t1 - t0);
+        if (!consistent) {
+            findDeadEnd ();
+            return 0;
+        }
         //printPuzzle();
-        return solveBacktrack (0, 0, problemMatrix);
+        int found;
+        if (engine == ENGINE_DLX)
+            found = links->solve (board.cells, limit, solution, nodes, budget);
+        else if (engine == ENGINE_CDCL)
+            found = learner->solve (board.cells, limit, solution, nodes, budget);
+        else if ((found = solveBacktrack (limit)) == SEARCH_HANDOVER) {
+            if (learner == NULL)
+                learner = new BasicConflictSolver<Geometry>;
+            found = learner->solve (board.cells, limit, solution, nodes, budget);
+        }
+        SUDOKU_STAT (stats.searchCells -= stats.logicalCells);
+        SUDOKU_STAT (stats.nodes = nodes);
+        SUDOKU_STAT (stats.searchMicros = statClock () - t1);
+        return found;
+    }
+
+#ifdef SUDOKU_STATS
+    /*  This method returns a monotonic time stamp in microseconds.
+     */
+    static double statClock (void) {
+        return chrono::duration<double, micro> (chrono::steady_clock::now ().time_since_epoch ()).count ();
+    }
+#endif
+
+    /*  Units are numbered 0 to UNITS - 1: the NUM rows, then the NUM
+     *  columns, then the NUM blocks (see SudokuGeometry). This method
+     *  returns the tag of unit u, the values already placed in it.
+     */
+    Mask unitTag (int u) {
+        return board.tags[u];
+    }
+
+    /*  These methods keep the set of dirty units, one bit per unit.
+     */
+    void markUnit (int u) {
+        dirtyUnits[u >> 6] |= 1ull << (u & 63);
+    }
+
+    void markCellUnits (int k) {
+        markUnit (geo.cellRow[k]);
+        markUnit (NUM + geo.cellCol[k]);
+        markUnit (2 * NUM + geo.cellBlk[k]);
+    }
+
+    void clearDirtyUnits (void) {
+        for (int w = 0; w < UNIT_WORDS; w++)
+            dirtyUnits[w] = 0;
+    }
+
+    /*  This method removes the lowest dirty unit from the set and returns
+     *  it, or -1 if no unit is dirty.
+     */
+    int takeDirtyUnit (void) {
+        for (int w = 0; w < UNIT_WORDS; w++)
+            if (dirtyUnits[w]) {
+                int u = w * 64 + __builtin_ctzll (dirtyUnits[w]);
+                dirtyUnits[w] &= dirtyUnits[w] - 1;
+                return u;
+            }
+        return -1;
+    }
+
+    /*  This method writes the value n to the empty cell k and keeps the
+     *  logical solver's work lists up to date. Every empty peer (a cell that
+     *  shares a row, column or block with k) that could hold n loses
+     *  that candidate, so its units are marked dirty for the hidden single
+     *  scan, and it is queued if it is left with a single candidate. It
+     *  returns false if a peer is left with no candidate at all.
+     */
+    bool placeValue (int cell, int n) {
+        Mask bit = 1 << (n - 1);
+        const Index *peer = geo.peers[cell];
+        int lost [PEERS], cnt = 0;
+
+        for (int k = 0; k < PEERS; k++) // Collect the peers that lose n.
+            if (cellValue (peer[k]) == 0 && (cellCandidates (peer[k]) & bit))
+                lost[cnt++] = peer[k];
+
+        markCellUnits (cell);
+        cellValue (cell) = (uint8_t) n;
+        assignTag (geo.cellRow[cell], geo.cellCol[cell], n);
+        SUDOKU_STAT (stats.searchCells++);
+
+        for (int k = 0; k < cnt; k++) {
+            Mask cand = cellCandidates (lost[k]);
+            if (cand == 0)
+                return false;
+            markCellUnits (lost[k]);
+            if (!(cand & (cand - 1))) // One candidate left, a naked single.
+                singleQueue[queueLen++] = lost[k];
+        }
+        return true;
     }
 
     /*  This method tries to solve the puzzle logically. It's a simple set of
-     *  implication rules. It goes on checking in each block, row and then
-     *  column to check if there are any singles (cells where only one value
-     *  can be put). If it finds such cells then it assigns the value.
+     *  implication rules. It looks for naked singles (empty cells where only
+     *  one value can be put) and hidden singles (values that fit only one
+     *  cell of a row, column or block) and assigns them.
      *
-     *  The method is in an infinite loop. Until it does not have any value to
-     *  assign to any cell it stays in the loop otherwise it breaks out.
+     *  Instead of sweeping the board again and again, the method starts with
+     *  every unit marked dirty and every naked single queued. From there on
+     *  placeValue queues the new naked singles and marks the units whose
+     *  candidates changed, so only those get scanned for hidden singles.
+     *  It returns false as soon as a contradiction is found.
      */
-    void solveLogical (void) {
-        int i, j, k, l = 0, row = 0, col = 0, cnt = 0;
-        bool flagNotSingle = false; // Used to check if the cell is indeed a singles cell.
-        bool flagValueSet = false;  // Is set if we made an assignment in the while loop.
+    bool solveLogical (void) {
+        queueLen = 0;
+        clearDirtyUnits ();
+        for (int u = 0; u < UNITS; u++)
+            markUnit (u);
+        if constexpr (B == 3) { // One vector pass finds the singles and dead cells.
+            CandidateScan scan;
+            scanBoard (scan);
+            if (scan.best >= 0 && scan.bestCount == 0)
+                return false;
+            for (int w = 0; w < 2; w++)
+                for (uint64_t s = scan.singles[w]; s; s &= s - 1)
+                    singleQueue[queueLen++] = w * 64 + __builtin_ctzll (s);
+            return propagate ();
+        }
+        for (int k = 0; k < CELLS; k++) {
+            if (cellValue (k) > 0)
+                continue;
+            Mask cand = cellCandidates (k);
+            if (cand == 0)
+                return false;
+            if (!(cand & (cand - 1)))
+                singleQueue[queueLen++] = k;
+        }
+        return propagate ();
+    }
+
+    /*  This method runs the technique passes on the board the logical
+     *  solver left and places the digits they add. It returns false if the
+     *  passes find the board dead.
+     */
+    bool solveTechniques (void) {
+        if (rater == NULL)
+            rater = new BasicTechniqueRater<Geometry>;
+        if (rater->rate (board.cells, techniques) == TECH_DEAD)
+            return false;
+        queueLen = 0;
+        clearDirtyUnits ();
+        for (int k = 0; k < CELLS; k++)
+            if (cellValue (k) == 0 && rater->value[k] != 0 && !placeValue (k, rater->value[k]))
+                return false;
+        return propagate ();
+    }
+
+    /*  This method empties the work lists of the logical solver. Naked
+     *  singles are cheap, so the queue is always drained before the next
+     *  dirty unit is scanned. It returns false on a contradiction.
+     */
+    bool propagate (void) {
+        int head = 0;
         while (true) {
-            flagValueSet = false; // Assume we make no assignment.
-            for (k = 0; k < NUM; k++) { // Check all the 9 blocks for singles.
-                for (l = 1; l < (NUM+1); l++) {
-                    cnt = 0;
-                    flagNotSingle = false; // Assume we have no singles.
-                    for (i = (k/COL)*COL; i < ((k/COL)*COL + COL); i++) {
-                        for (j = (k%COL)*ROW; j < ((k%COL)*ROW + ROW); j++) {
-                            if (problemMatrix [i][j] > 0) // Skip the cells that are already filled.
-                                continue;
-                            if (checkValid (i,j,l)) { // If empty cell found, check if current value is valid.
-                                row = i;
-                                col = j;
-                                cnt ++;
-                            }
-                            if (cnt > 1) { // Make sure it was a singles value and not doubles or more.
-                                flagNotSingle = true; // If more than one valid value was found, break.
-                                break;
-                            }
-                        }
-                        if (flagNotSingle) // More than one valid value found, break.
-                            break;
-                    }
-                    if (cnt == 1) { // If any singles value was found then assign it.
-                        problemMatrix [row][col] = l;
-                        assignTag (row, col, l); // Then set tags.
-                        flagValueSet = true; // Set the flag that assignment was made.
-                    }
-                }
+            while (head < queueLen) { // Place the queued naked singles.
+                int cell = singleQueue[head++];
+                if (cellValue (cell) > 0) // Already placed by a hidden single.
+                    continue;
+                Mask cand = cellCandidates (cell);
+                if (cand == 0 || !placeValue (cell, __builtin_ctz (cand) + 1))
+                    return false;
             }
-
-            for (i = 0; i < NUM; i++) { // Check all columns.
-                for (l = 1; l < NUM; l++) {
-                    cnt = 0;
-                    for (j = 0; j < NUM; j++) {
-                        if (problemMatrix [i][j] > 0) // Skip cells that are already filled.
-                            continue;
-                        if (checkValid (i, j, l)) { // If empty cell found, check if current value is valid.
-                            row = i;
-                            col = j;
-                            cnt++;
-                        }
-                        if (cnt > 1) { // Make sure it was a singles value and not doubles or more.
-                            flagNotSingle = true; // If more than one valid value was found, break.
-                            break;
-                        }
-                    }
-                    if (cnt == 1) { // If any singles value was found then assign it.
-                        problemMatrix [row][col] = l;
-                        assignTag (row, col, l); // Then set tags.
-                        flagValueSet = true; // Set the flag that assignment was made.
-                    }
-                }
+            int u = takeDirtyUnit ();
+            if (u < 0) {
+                queueLen = 0;
+                return true;
             }
+            if (!scanUnit (u))
+                return false;
+        }
+    }
 
-            for (i = 0; i < NUM; i++) { // Check all rows.
-                for (l = 1; l < NUM; l++) {
-                    cnt = 0;
-                    for (j = 0; j < NUM; j++) {
-                        if (problemMatrix [j][i] > 0) // Skip cells that are already filled.
-                            continue;
-                        if (checkValid (j, i, l)) { // If empty cell found, check if current value is valid.
-                            row = j;
-                            col = i;
-                            cnt++;
-                        }
-                        if (cnt > 1) { // Make sure it was a singles value and not doubles or more.
-                            flagNotSingle = true; // If more than one valid value was found, break.
-                            break;
-                        }
-                    }
-                    if (cnt == 1) { // If any singles value was found then assign it.
-                        problemMatrix [row][col] = l;
-                        assignTag (row, col, l); // Then set tags.
-                        flagValueSet = true; // Set the flag that assignment was made.
-                    }
-                }
-            }
-            if(!flagValueSet) // If assignment was not made during an iteration, break out of logical solve.
-                break;
+    /*  This method looks for hidden singles in unit u. 'once' collects the
+     *  values that fit at least one empty cell and 'twice' those that fit
+     *  two or more, so once & ~twice are the values with a single place. A
+     *  value that is neither placed nor fits anywhere is a contradiction.
+     */
+    bool scanUnit (int u) {
+        const Index *cells = geo.unitCells[u];
+        Mask once = 0, twice = 0;
+        for (int k = 0; k < NUM; k++) {
+            if (cellValue (cells[k]) > 0)
+                continue;
+            Mask cand = cellCandidates (cells[k]);
+            twice |= once & cand;
+            once |= cand;
         }
+        if ((once | unitTag (u)) != tagFull)
+            return false;
+        for (Mask hidden = once & ~twice; hidden; hidden &= hidden - 1) {
+            Mask bit = hidden & -hidden;
+            int k = 0;
+            for (; k < NUM; k++) // Find the one cell that takes the value.
+                if (cellValue (cells[k]) == 0 && (cellCandidates (cells[k]) & bit))
+                    break;
+            if (k == NUM || !placeValue (cells[k], __builtin_ctz (bit) + 1))
+                return false;
+        }
+        return true;
     }
 
     /*  This method is called after the logical solver. This method can be
@@ -281,55 +736,156 @@ class SudokuSolver {
      *  For simple puzzles, logical solve will give the result and this method
      *  will just exit on initial check.
      *
-     *  The method is simple, it is similar to logical solve but instead of
-     *  checking if the value is singles or not, it only checks if the value
-     *  is valid, if it is then the solver assumes that to be the correct value
-     *  and advances, if it encounters an error, it goes back to last modified
-     *  cell and checks for another valid value. If there is none it goes back
+     *  The method branches on the empty cell with the fewest candidates
+     *  (minimum remaining values). It assumes each candidate in turn and runs
+     *  the logical solver's propagation on top of the guess, so every node
+     *  also fills whatever singles the guess implies. If that leads to a
+     *  contradiction, the board is put back the way it was before the guess
+     *  and the next candidate is tried. If there is none it goes back
      *  another step and so on till all the cells are filled.
+     *
+     *  The search does not recurse. Each open branching cell is one entry of
+     *  searchStack holding the candidates not tried yet, and saved[] holds
+     *  a copy of the board from before its first guess. Restoring that copy
+     *  is cheaper than undoing the assignments one at a time. Every entry
+     *  fills at least one cell, so CELLS entries are always enough and
+     *  nothing is allocated.
+     *
+     *  A full board is counted and then treated like a dead end, so the
+     *  search carries on until 'limit' solutions are found or the tree is
+     *  exhausted. It returns the number found; the first one is copied to
+     *  'solution'. Once more than handoverNodes guesses are made it stops,
+     *  puts the board back as it was before the first guess and returns
+     *  SEARCH_HANDOVER. When the budget runs out it stops with the
+     *  solutions found so far.
      */
-    bool solveBacktrack (int i, int j, int proMat [9][9]) {
-        if (i == NUM) { // This function goes checking row after row.
-            i = 0;
-            if (++j == NUM)   // Once a row is finished, go to next row.
-                return true; // If final cell is reached, puzzle is solved.
+    int solveBacktrack (int limit) {
+        int depth = 0, cell, found = 0;
+        Mask cand;
+
+        if ((cell = selectCell (cand)) < 0) {
+            if (cell == SELECT_DEAD)
+                return 0;
+            saveSolution ();
+            return 1;
         }
-        if (proMat[i][j] > 0)  // Skip filled cells
-            return solveBacktrack (i + 1, j, proMat); // Check next row of current column.
-
-        for (int val = 1; val <= NUM; val++) { // Empty cell found. Check from 1 to 9.
-            if (checkValid(i, j, val)) { // If it is legal (check description of legal) then fill the cell.
-                proMat[i][j] = val;
-                assignTag (i, j, val); // Also set the tags for checking next value.
-                if (solveBacktrack (i+1,j,proMat)) // And call the solve function again.
-                    return true; // If it returns true that means the puzzle is solved.
-                else // If not then we need to reset the tags and backtrack.
-                    resetTag (i, j, proMat[i][j]);
+        saved[depth] = board;
+        searchStack[depth++] = { cell, cand };
+        SUDOKU_STAT (stats.maxDepth = 1);
+        SUDOKU_STAT (bool pushed = true);
+
+        while (depth > 0) {
+            SearchFrame &frame = searchStack[depth - 1];
+            SUDOKU_STAT (stats.backtracks += !pushed);
+            SUDOKU_STAT (pushed = false);
+            if (frame.remaining == 0) { // Every value failed, backtrack.
+                depth--;
+                continue;
+            }
+            int val = __builtin_ctz (frame.remaining) + 1;
+            frame.remaining &= frame.remaining - 1;
+            board = saved[depth - 1]; // Take back the last guess at this cell.
+            if (++nodes > handoverNodes && handoverNodes > 0) {
+                board = saved[0];
+                return SEARCH_HANDOVER;
             }
+            if (budget.spent (nodes))
+                return found;
+
+            queueLen = 0;
+            clearDirtyUnits ();
+            if (!placeValue (frame.cell, val) || !propagate ())
+                continue;
+            if ((cell = selectCell (cand)) < 0) {
+                if (cell == SELECT_SOLVED) {
+                    if (found++ == 0)
+                        saveSolution ();
+                    if (found == limit)
+                        return found;
+                }
+                continue;
+            }
+            saved[depth] = board;
+            searchStack[depth++] = { cell, cand };
+            SUDOKU_STAT (pushed = true);
+            SUDOKU_STAT (stats.maxDepth = depth > stats.maxDepth ? depth : stats.maxDepth);
         }
-        resetTag (i, j, proMat[i][j]); // Reset tags and backtrack.
-        proMat[i][j] = 0; // Also reset the value for next iteration.
-        return false;
+        return found;
+    }
+
+    /*  This method copies the cells of the full board to 'solution'.
+     */
+    void saveSolution (void) {
+        memcpy (solution, board.cells, sizeof (solution));
     }
 
-    /*  This method is used to print the problem matrix to console. Mainly used
+    /*  This method runs the candidate kernel over the 9x9 board. The
+     *  kernel reads whole vectors, which stay inside the Board: the cells
+     *  are padded by the tags and the tags by the alignment.
+     */
+    void scanBoard (CandidateScan &scan) {
+        static_assert (offsetof (Board, tags) >= 82 && offsetof (Board, tags) + 64 <= sizeof (Board)
+                       && SCAN_PADDED <= sizeof (Board), "the kernel reads past the board");
+        SUDOKU_STAT (stats.checks += CELLS);
+        scanCandidates (board.cells, (const uint16_t *) board.tags, scan);
+    }
+
+    /*  This method picks the empty cell with the fewest candidates and
+     *  returns its index (i * NUM + j) with its candidates in 'cand'. It
+     *  returns SELECT_SOLVED if no cell is empty and SELECT_DEAD if some
+     *  cell has no candidate left.
+     */
+    int selectCell (Mask &cand) {
+        if constexpr (B == 3) {
+            CandidateScan scan;
+            scanBoard (scan);
+            if (scan.best < 0)
+                return SELECT_SOLVED;
+            if (scan.bestCount == 0)
+                return SELECT_DEAD;
+            cand = cellCandidates (scan.best);
+            return scan.best;
+        }
+        int best = SELECT_SOLVED, bestCount = NUM + 1;
+        for (int k = 0; k < CELLS && bestCount > 2; k++) {
+            if (cellValue (k) > 0)
+                continue;
+            Mask c = cellCandidates (k);
+            int count = __builtin_popcount (c);
+            if (count == 0)
+                return SELECT_DEAD;
+            if (count < bestCount) {
+                best = k;
+                bestCount = count;
+                cand = c;
+            }
+        }
+        return best;
+    }
+
+    /*  This method is used to print the board to console. Mainly used
      *  for debugging purpose.
      */
     void printPuzzle (void) {
-        cout << "-------------------------------------------------------" << endl;
+        string rule (NUM * 6 + 1, '-');
+        rule += '\n';
+        string text = rule;
         for (int row = 0; row < NUM; row++) {
-            cout << "| ";
+            text += "| ";
             for (int col = 0; col < NUM; col++) {
-                cout << " *" << problemMatrix[row][col] << "* ";
+                text += " *" + to_string ((int) board.cells[row * NUM + col]) + "* ";
                 if (!((col+1) % BLK))
-                    cout << " | ";
+                    text += " | ";
             }
+            text += '\n';
             if (!((row+1) % BLK))
-                cout << endl << "-------------------------------------------------------" << endl;
-            else
-                cout << endl;
+                text += rule;
         }
+        cout << text;
     }
 
 };
 
+typedef BasicSudokuSolver<3> SudokuSolver;  // The classic 9x9 puzzle
+
+#endif
@@ -0,0 +1,498 @@
+/*
+ ******************************************************************************
+ *
+ *  fileName    :   TechniqueRater.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *
+ *  Version     :   1.0.0
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Human style solving in tiers, past the naked and hidden
+ *                  singles of the logical solver, and a difficulty rating
+ *                  from the techniques a puzzle needs.
+ *
+ *                  The solver's board only has unit tags, so it cannot
+ *                  remember a candidate that was struck out without a digit
+ *                  being placed. The rater keeps the candidates itself, in
+ *                  two bit layouts that are updated together: one mask of
+ *                  values per cell, and one mask of places per value and
+ *                  unit (bit s of where[u][v] is set while v still fits the
+ *                  s-th cell of unit u). A naked subset is an OR of cell
+ *                  masks and a hidden one an OR of place masks, a pointing
+ *                  value is a place mask inside one segment, and the rows
+ *                  of an X-wing are two equal place masks.
+ *
+ *                  The passes, cheapest first:
+ *                      TECH_LOCKED     pointing and claiming
+ *                      TECH_PAIRS      naked and hidden pairs
+ *                      TECH_TRIPLES    naked and hidden triples
+ *                      TECH_XWING      X-wings in rows and columns
+ *                  rate () runs the singles until they stall, then the
+ *                  first enabled pass that strikes a candidate, and goes
+ *                  back to the singles. A pass only looks at the units
+ *                  whose candidates changed since it last ran: every
+ *                  struck candidate marks the three units of its cell in
+ *                  one dirty set per pass, so nothing is scanned twice
+ *                  for nothing.
+ *
+ *                  The score adds TECH_*_SCORE for every step taken and
+ *                  TECH_SEARCH_SCORE for every cell still empty when all
+ *                  the passes stall. 'level' is the hardest technique used,
+ *                  TECH_LEVEL_SEARCH if that was not enough.
+ *
+ *                  BasicSudokuSolver runs the passes of its 'techniques'
+ *                  mask after the logical solver and places the digits
+ *                  they find before the search starts.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Notes       :   The class is a template on the geometry (SudokuGeometry<B>)
+ *                  rather than on B so it can be included ahead of it.
+ *
+ ******************************************************************************
+ */
+
+#ifndef TECHNIQUERATER_CC
+#define TECHNIQUERATER_CC
+
+#include <cstring>
+#include <stdint.h>
+#include <type_traits>
+
+/*  Passes of BasicTechniqueRater::rate (), as bits of its 'tiers' mask.
+ */
+enum TechniqueTier {
+    TECH_LOCKED = 1,    // Pointing and claiming
+    TECH_PAIRS = 2,     // Naked and hidden pairs
+    TECH_TRIPLES = 4,   // Naked and hidden triples
+    TECH_XWING = 8,     // X-wings in rows and columns
+    TECH_ALL = 15
+};
+
+#define TECH_PASSES         4       // Bits of TechniqueTier
+
+/*  Outcome of BasicTechniqueRater::rate ().
+ */
+enum TechniqueStatus {
+    TECH_SOLVED = 0,    // The board is full
+    TECH_STALLED,       // No pass strikes anything, the rest needs a search
+    TECH_DEAD           // A cell or a unit ran out of candidates
+};
+
+/*  Hardest technique of a rating: the singles, then the passes in order.
+ */
+#define TECH_LEVEL_SINGLES  0
+#define TECH_LEVEL_SEARCH   (TECH_PASSES + 1)
+
+#define TECH_NAKED_SCORE    1       // Score of each step
+#define TECH_HIDDEN_SCORE   2
+#define TECH_LOCKED_SCORE   10
+#define TECH_PAIRS_SCORE    20
+#define TECH_TRIPLES_SCORE  40
+#define TECH_XWING_SCORE    60
+#define TECH_SEARCH_SCORE   100     // Per cell left to the search
+
+/*  This function returns the name of a rating level.
+ */
+inline const char *techniqueName (int level) {
+    static const char *names [TECH_LEVEL_SEARCH + 1] = { "singles", "locked", "pairs", "triples", "xwing", "search" };
+    return level >= 0 && level <= TECH_LEVEL_SEARCH ? names[level] : "none";
+}
+
+template <class Geometry>
+class BasicTechniqueRater {
+
+    public:
+
+        static constexpr int NUM = Geometry::NUM;
+        static constexpr int ROW = Geometry::ROW;
+        static constexpr int CELLS = Geometry::CELLS;
+        static constexpr int UNITS = Geometry::UNITS;
+        static constexpr int PEERS = Geometry::PEERS;
+        static constexpr int UNIT_WORDS = (UNITS + 63) / 64;
+
+        typedef typename std::conditional<(NUM <= 16), uint16_t, uint32_t>::type Mask;
+        typedef bool (BasicTechniqueRater::*Pass) (void);
+
+        static constexpr Geometry geo = Geometry ();
+        static constexpr Mask full = (Mask) ((1ull << NUM) - 1);   // All NUM bits set
+
+        Mask        cand [CELLS];           // Values left for each empty cell, 0 once filled
+        uint8_t     value [CELLS];          // Value of each cell, 0 if empty
+        Mask        placed [UNITS];         // Values placed in each unit
+        Mask        where [UNITS][NUM];     // Places left in each unit for each value
+        uint8_t     slot [CELLS][3];        // Place of each cell in its row, column and block
+        Mask        segment [ROW];          // Places of a unit in block row or line segment r
+        Mask        stripe [ROW];           // Places of a block in block column c
+        uint64_t    dirty [TECH_PASSES + 1][UNIT_WORDS];   // Units to look at, singles first
+        int         queue [CELLS];          // Cells left with one candidate
+        int         queueHead, queueLen;
+        int         filled;                 // Cells with a value
+        bool        dead;                   // A candidate ran out
+        int         status;                 // TechniqueStatus of the last rate ()
+        int         level;                  // Hardest technique of the last rate ()
+        long        score;                  // Difficulty score of the last rate ()
+        long        steps [TECH_LEVEL_SEARCH];  // Steps of the last rate () per technique
+
+    BasicTechniqueRater (void) {
+        for (int u = 0; u < UNITS; u++)
+            for (int s = 0; s < NUM; s++)
+                slot[geo.unitCells[u][s]][u / NUM] = (uint8_t) s;
+        for (int r = 0; r < ROW; r++) {
+            segment[r] = stripe[r] = 0;
+            for (int m = 0; m < ROW; m++) {
+                segment[r] |= (Mask) (1u << (r * ROW + m));
+                stripe[r] |= (Mask) (1u << (m * ROW + r));
+            }
+        }
+        status = TECH_DEAD;
+        level = TECH_LEVEL_SINGLES;
+        score = 0;
+        memset (steps, 0, sizeof (steps));
+    }
+
+    BasicTechniqueRater (const BasicTechniqueRater &) = delete;
+    BasicTechniqueRater &operator= (const BasicTechniqueRater &) = delete;
+
+    /*  This method solves the board of 'cells' (0 for empty) as far as the
+     *  singles and the passes of 'tiers' go and returns a TechniqueStatus.
+     *  'value' then holds the board, and 'level', 'score' and 'steps' the
+     *  rating.
+     */
+    int rate (const uint8_t *cells, int tiers) {
+        static constexpr Pass passes [TECH_PASSES] = {
+            &BasicTechniqueRater::lockedPass, &BasicTechniqueRater::pairsPass,
+            &BasicTechniqueRater::triplesPass, &BasicTechniqueRater::xwingPass
+        };
+        level = TECH_LEVEL_SINGLES;
+        score = 0;
+        memset (steps, 0, sizeof (steps));
+        if (!load (cells))
+            return status = TECH_DEAD;
+        while (true) {
+            if (!singles ())
+                return status = TECH_DEAD;
+            if (filled == CELLS)
+                return status = TECH_SOLVED;
+            int t = 0;
+            while (t < TECH_PASSES && !(((tiers >> t) & 1) && (this->*passes[t]) ()))
+                t++;
+            if (dead)
+                return status = TECH_DEAD;
+            if (t == TECH_PASSES) {
+                level = TECH_LEVEL_SEARCH;
+                score += TECH_SEARCH_SCORE * (long) (CELLS - filled);
+                return status = TECH_STALLED;
+            }
+            if (t + 1 > level)
+                level = t + 1;
+        }
+    }
+
+    /*  This method sets up both candidate layouts for the board and queues
+     *  its naked singles. It returns false if the board is already dead.
+     */
+    bool load (const uint8_t *cells) {
+        dead = false;
+        filled = 0;
+        queueHead = queueLen = 0;
+        memset (placed, 0, sizeof (placed));
+        for (int k = 0; k < CELLS; k++) {
+            value[k] = cells[k];
+            if (cells[k] == 0)
+                continue;
+            Mask bit = (Mask) (1u << (cells[k] - 1));
+            for (int m = 0; m < 3; m++) {
+                if (placed[unitOf (k, m)] & bit)
+                    return false;
+                placed[unitOf (k, m)] |= bit;
+            }
+            filled++;
+        }
+        for (int k = 0; k < CELLS; k++) {
+            cand[k] = 0;
+            if (value[k] != 0)
+                continue;
+            cand[k] = (Mask) (full & ~(placed[unitOf (k, 0)] | placed[unitOf (k, 1)] | placed[unitOf (k, 2)]));
+            if (cand[k] == 0)
+                return false;
+            if (!(cand[k] & (cand[k] - 1)))
+                queue[queueLen++] = k;
+        }
+        for (int u = 0; u < UNITS; u++) {
+            memset (where[u], 0, sizeof (where[u]));
+            for (int s = 0; s < NUM; s++)
+                for (Mask c = cand[geo.unitCells[u][s]]; c; c &= c - 1)
+                    where[u][__builtin_ctz (c)] |= (Mask) (1u << s);
+            for (Mask open = (Mask) (full & ~placed[u]); open; open &= open - 1)
+                if (where[u][__builtin_ctz (open)] == 0)
+                    return false;
+        }
+        for (int p = 0; p <= TECH_PASSES; p++)
+            for (int w = 0; w < UNIT_WORDS; w++)
+                dirty[p][w] = w + 1 < UNIT_WORDS || UNITS % 64 == 0 ? ~0ull : (1ull << (UNITS % 64)) - 1;
+        return true;
+    }
+
+    /*  This method returns unit m of cell k: its row, column or block.
+     */
+    static int unitOf (int k, int m) {
+        return m == 0 ? geo.cellRow[k] : m == 1 ? NUM + geo.cellCol[k] : 2 * NUM + geo.cellBlk[k];
+    }
+
+    /*  This method marks unit u dirty for every pass.
+     */
+    void markDirty (int u) {
+        for (int p = 0; p <= TECH_PASSES; p++)
+            dirty[p][u >> 6] |= 1ull << (u & 63);
+    }
+
+    /*  This method removes the lowest dirty unit of pass p from its set and
+     *  returns it, or -1 if none is left.
+     */
+    int takeDirty (int p) {
+        for (int w = 0; w < UNIT_WORDS; w++)
+            if (dirty[p][w]) {
+                int u = w * 64 + __builtin_ctzll (dirty[p][w]);
+                dirty[p][w] &= dirty[p][w] - 1;
+                return u;
+            }
+        return -1;
+    }
+
+    /*  This method strikes value v (from 0) off the empty cell k in both
+     *  layouts. It returns true if v was still a candidate. A cell or a
+     *  unit left without a place sets 'dead', a cell left with one value
+     *  is queued.
+     */
+    bool strike (int k, int v) {
+        Mask bit = (Mask) (1u << v);
+        if (value[k] != 0 || !(cand[k] & bit))
+            return false;
+        cand[k] &= (Mask) ~bit;
+        for (int m = 0; m < 3; m++) {
+            int u = unitOf (k, m);
+            where[u][v] &= (Mask) ~(1u << slot[k][m]);
+            markDirty (u);
+            if (where[u][v] == 0 && !(placed[u] & bit))
+                dead = true;
+        }
+        if (cand[k] == 0)
+            dead = true;
+        else if (!(cand[k] & (cand[k] - 1)))
+            queue[queueLen++] = k;
+        return true;
+    }
+
+    /*  This method strikes every value of 'values' off the empty cells at
+     *  the places 'slots' of unit u, and returns true if one went.
+     */
+    bool strikeCells (int u, Mask slots, Mask values) {
+        bool struck = false;
+        for (; slots; slots &= slots - 1)
+            for (Mask v = values; v; v &= v - 1)
+                struck |= strike (geo.unitCells[u][__builtin_ctz (slots)], __builtin_ctz (v));
+        return struck;
+    }
+
+    /*  This method writes value v (from 0) to the empty cell k: the other
+     *  values of k go, then v goes from the peers.
+     */
+    void place (int k, int v) {
+        Mask bit = (Mask) (1u << v);
+        for (Mask others = (Mask) (cand[k] & ~bit); others; others &= others - 1)
+            strike (k, __builtin_ctz (others));
+        value[k] = (uint8_t) (v + 1);
+        cand[k] = 0;
+        filled++;
+        for (int m = 0; m < 3; m++) {
+            int u = unitOf (k, m);
+            placed[u] |= bit;
+            where[u][v] = 0;
+            markDirty (u);
+        }
+        for (int p = 0; p < PEERS; p++)
+            strike (geo.peers[k][p], v);
+    }
+
+    /*  This method places naked singles from the queue and hidden singles
+     *  of the dirty units until there are none. It returns false if the
+     *  board is dead.
+     */
+    bool singles (void) {
+        while (!dead) {
+            if (queueHead < queueLen) {
+                int k = queue[queueHead++];
+                if (value[k] == 0) {
+                    place (k, __builtin_ctz (cand[k]));
+                    steps[TECH_LEVEL_SINGLES]++;
+                    score += TECH_NAKED_SCORE;
+                }
+                continue;
+            }
+            int u = takeDirty (0);
+            if (u < 0)
+                break;
+            for (Mask open = (Mask) (full & ~placed[u]); open && !dead; open &= open - 1) {
+                Mask w = where[u][__builtin_ctz (open)];
+                if (w == 0 || (w & (w - 1)))
+                    continue;
+                place (geo.unitCells[u][__builtin_ctz (w)], __builtin_ctz (open));
+                steps[TECH_LEVEL_SINGLES]++;
+                score += TECH_HIDDEN_SCORE;
+            }
+        }
+        return !dead;
+    }
+
+    /*  This method counts one step of technique 'level' that struck
+     *  something.
+     */
+    void took (int level, long points) {
+        steps[level]++;
+        score += points;
+    }
+
+    /*  Pointing and claiming. In a block, a value whose places are all in
+     *  one row or column goes from the rest of that line; in a row or
+     *  column, a value whose places are all in one block goes from the
+     *  rest of the block.
+     */
+    bool lockedPass (void) {
+        bool struck = false;
+        int u;
+        while (!dead && (u = takeDirty (1)) >= 0)
+            for (Mask open = (Mask) (full & ~placed[u]); open && !dead; open &= open - 1) {
+                int v = __builtin_ctz (open);
+                Mask w = where[u][v];
+                if (w == 0)
+                    continue;
+                int s = __builtin_ctz (w), k = geo.unitCells[u][s], line = -1;
+                if (u >= 2 * NUM && !(w & ~segment[s / ROW]))
+                    line = unitOf (k, 0);
+                else if (u >= 2 * NUM && !(w & ~stripe[s % ROW]))
+                    line = unitOf (k, 1);
+                else if (u < 2 * NUM && !(w & ~segment[s / ROW]))
+                    line = unitOf (k, 2);
+                if (line < 0)
+                    continue;
+                Mask rest = 0; // Places of 'line' outside unit u.
+                for (int t = 0; t < NUM; t++)
+                    if (unitOf (geo.unitCells[line][t], u / NUM) != u)
+                        rest |= (Mask) (1u << t);
+                if (strikeCells (line, rest, (Mask) (1u << v))) {
+                    took (1, TECH_LOCKED_SCORE);
+                    struck = true;
+                }
+            }
+        return struck;
+    }
+
+    bool pairsPass (void) {
+        return subsetPass (2, 2, TECH_PAIRS_SCORE);
+    }
+
+    bool triplesPass (void) {
+        return subsetPass (3, 3, TECH_TRIPLES_SCORE);
+    }
+
+    /*  Naked and hidden subsets of n = 2 or 3 in the units of pass p. n
+     *  cells whose values make n in all go from the other cells of the
+     *  unit; n values whose places make n in all leave those cells no
+     *  other value.
+     */
+    bool subsetPass (int n, int p, long points) {
+        bool struck = false;
+        int u;
+        while (!dead && (u = takeDirty (p)) >= 0) {
+            int cells [NUM], vals [NUM], nc = 0, nv = 0;
+            Mask open = 0;
+            for (int s = 0; s < NUM; s++) {
+                int k = geo.unitCells[u][s];
+                if (value[k] != 0)
+                    continue;
+                open |= (Mask) (1u << s);
+                if (__builtin_popcount (cand[k]) <= n)
+                    cells[nc++] = s;
+            }
+            for (Mask o = (Mask) (full & ~placed[u]); o; o &= o - 1)
+                if (__builtin_popcount (where[u][__builtin_ctz (o)]) <= n)
+                    vals[nv++] = __builtin_ctz (o);
+            if (__builtin_popcount (open) <= n) // Nothing outside a subset to strike.
+                continue;
+
+            for (int a = 0; a < nc && !dead; a++)
+                for (int b = a + 1; b < nc && !dead; b++)
+                    for (int c = n == 3 ? b + 1 : b; c < (n == 3 ? nc : b + 1) && !dead; c++) {
+                        Mask used = cand[geo.unitCells[u][cells[a]]] | cand[geo.unitCells[u][cells[b]]]
+                                    | cand[geo.unitCells[u][cells[c]]];
+                        Mask in = (Mask) ((1u << cells[a]) | (1u << cells[b]) | (1u << cells[c]));
+                        if (__builtin_popcount (used) == n && strikeCells (u, (Mask) (open & ~in), used)) {
+                            took (n, points);
+                            struck = true;
+                        }
+                    }
+            for (int a = 0; a < nv && !dead; a++)
+                for (int b = a + 1; b < nv && !dead; b++)
+                    for (int c = n == 3 ? b + 1 : b; c < (n == 3 ? nv : b + 1) && !dead; c++) {
+                        Mask at = where[u][vals[a]] | where[u][vals[b]] | where[u][vals[c]];
+                        Mask in = (Mask) ((1u << vals[a]) | (1u << vals[b]) | (1u << vals[c]));
+                        if (__builtin_popcount (at) == n && strikeCells (u, at, (Mask) (full & ~in))) {
+                            took (n, points);
+                            struck = true;
+                        }
+                    }
+        }
+        return struck;
+    }
+
+    /*  X-wings. Two rows where a value has the same two places, both in
+     *  the same two columns, take the value from the rest of those
+     *  columns; and the same with rows and columns swapped. Only dirty
+     *  lines are taken as the first of the two.
+     */
+    bool xwingPass (void) {
+        bool struck = false;
+        int u;
+        while (!dead && (u = takeDirty (4)) >= 0) {
+            if (u >= 2 * NUM)
+                continue;
+            int base = u < NUM ? 0 : NUM, cross = NUM - base;
+            for (Mask open = (Mask) (full & ~placed[u]); open && !dead; open &= open - 1) {
+                int v = __builtin_ctz (open);
+                Mask w = where[u][v];
+                if (__builtin_popcount (w) != 2)
+                    continue;
+                for (int u2 = base; u2 < base + NUM && !dead; u2++) {
+                    if (u2 == u || where[u2][v] != w)
+                        continue;
+                    Mask lines = (Mask) ((1u << (u - base)) | (1u << (u2 - base)));
+                    bool hit = false;
+                    for (Mask s = w; s; s &= s - 1) // Place s of a line is line s of the other kind.
+                        hit |= strikeCells (cross + __builtin_ctz (s), (Mask) (full & ~lines), (Mask) (1u << v));
+                    if (hit) {
+                        took (4, TECH_XWING_SCORE);
+                        struck = true;
+                    }
+                }
+            }
+        }
+        return struck;
+    }
+
+};
+
+#endif
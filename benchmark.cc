@@ -0,0 +1,411 @@
+/*
+ ******************************************************************************
+ *  fileName    :   benchmark.cc
+ *
+ *  Author      :   Aniket Awati <an.aaasss@gmail.com>
+ *  Version     :   1.0.0
+ *
+ *  Created     :   10/14/2026
+ *  Modified    :   10/14/2026
+ *
+ *  Description :   Benchmark for the SudokuSolver class. It loads puzzle
+ *                  corpora in the one-line-per-puzzle format and runs every
+ *                  solver stage in-process over them, one puzzle at a time
+ *                  on a single solver object. Per corpus and stage it
+ *                  reports puzzles per second, median and 99th percentile
+ *                  latency per puzzle, search nodes per puzzle and how many
+ *                  puzzles the stage solved.
+ *
+ *                  Stages:
+ *                      logical -   load the puzzle and run solveLogical ()
+ *                                  only; "solved" counts the puzzles that
+ *                                  need no search at all.
+ *                      solve   -   solve () with the full search.
+ *                      unique  -   solve () with the uniqueness check.
+ *                      dlx     -   solve () on the Dancing Links engine.
+ *                      dlx-uniq -  the same with the uniqueness check.
+ *                      cdcl    -   solve () on the clause learning engine.
+ *                      cached  -   solveCached () on the tag engine through
+ *                                  a SolutionCache made for the stage; the
+ *                                  first run fills it, later runs and
+ *                                  repeated or symmetric copies of a
+ *                                  puzzle hit it.
+ *                      split   -   solve () on a SplitSolver with a thread
+ *                                  per core, which splits the search of
+ *                                  the puzzles that outlast a short plain
+ *                                  solve; compare its p99 with "solve".
+ *                      tech    -   solve () with every technique pass of
+ *                                  TechniqueRater.cc before the search.
+ *                      rate    -   BasicTechniqueRater::rate () with every
+ *                                  pass and no search; "solved" counts the
+ *                                  puzzles the techniques finish.
+ *                  Comparing the solve, dlx and cdcl lines of a corpus shows
+ *                  which search engine suits that class of puzzles. The
+ *                  solve and unique stages hand over to clause learning the
+ *                  way the solver does by default (handoverNodes).
+ *
+ *                  Without file arguments the corpora in corpus/ are used:
+ *                      easy.txt    -   generated puzzles the logical stage
+ *                                      solves on its own.
+ *                      17clue.txt  -   minimal 17 clue puzzles from the
+ *                                      published collections and random
+ *                                      isomorphic variants of them.
+ *                      hardest.txt -   well known "hardest" puzzles (Inkala,
+ *                                      AI Escargot, Easter Monster, the top
+ *                                      of Norvig's list) and variants.
+ *                  Every puzzle in them has exactly one solution.
+ *
+ *  License     :   This program is free software: you can redistribute it and/or modify
+ *                  it under the terms of the GNU General Public License as published by
+ *                  the Free Software Foundation, either version 3 of the License, or
+ *                  (at your option) any later version.
+ *
+ *                  This program is distributed in the hope that it will be useful,
+ *                  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *                  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *                  GNU General Public License for more details.
+ *
+ *                  You should have received a copy of the GNU General Public License
+ *                  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Notes       :   Usage:
+ *                  benchmark [--repeat N] [CorpusFile ...]
+ *
+ *                  Every stage runs over the corpus N times (default 3) and
+ *                  the latencies of all runs are pooled. Built with
+ *                  -DSUDOKU_STATS it also prints the solve statistics of
+ *                  each full solve stage. The first line names the
+ *                  candidate kernel in use, see CandidateKernel.cc.
+ *
+ *                  benchmark --check-alloc [CorpusFile ...]
+ *
+ *                  checks instead that solving allocates nothing once the
+ *                  solvers are warm. The program counts every operator new.
+ *                  Each stage runs over the corpus once to warm up and once
+ *                  counted on the same solver, and so does a threaded
+ *                  BatchPool, plain and in lane mode, where the allocations
+ *                  of a run over no input (the threads) are taken off. Every
+ *                  count should be 0; the exit status is 1 if one is not.
+ *
+ ******************************************************************************
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <unistd.h>
+#include <vector>
+#include "SudokuSolver.cc"  // The SudokuSolver class.
+#include "PuzzleIO.cc"      // One-line-per-puzzle format.
+#include "PuzzleReader.cc"  // Line readers.
+#include "StatsSummary.cc"  // Solve statistics.
+#include "SolutionCache.cc" // Canonical form solution cache.
+#include "BatchPool.cc"     // Multithreaded batch solver.
+#include "SplitSolver.cc"   // Parallel search within one puzzle.
+
+using namespace std;
+
+/*  Every operator new of the program goes through here and is counted
+ *  for --check-alloc.
+ */
+static atomic<long> allocations (0);
+
+void *operator new (size_t n) {
+    allocations.fetch_add (1, memory_order_relaxed);
+    void *p = malloc (n ? n : 1);
+    if (p == NULL)
+        throw bad_alloc ();
+    return p;
+}
+
+void *operator new (size_t n, align_val_t a) {
+    allocations.fetch_add (1, memory_order_relaxed);
+    size_t align = (size_t) a;
+    void *p = aligned_alloc (align, (n + align - 1) / align * align);
+    if (p == NULL)
+        throw bad_alloc ();
+    return p;
+}
+
+void *operator new[] (size_t n) { return operator new (n); }
+void *operator new[] (size_t n, align_val_t a) { return operator new (n, a); }
+void operator delete (void *p) noexcept { free (p); }
+void operator delete[] (void *p) noexcept { free (p); }
+void operator delete (void *p, size_t) noexcept { free (p); }
+void operator delete[] (void *p, size_t) noexcept { free (p); }
+void operator delete (void *p, align_val_t) noexcept { free (p); }
+void operator delete[] (void *p, align_val_t) noexcept { free (p); }
+void operator delete (void *p, size_t, align_val_t) noexcept { free (p); }
+void operator delete[] (void *p, size_t, align_val_t) noexcept { free (p); }
+
+/*  Grid wrapper so puzzles can be kept in a vector.
+ */
+struct Puzzle {
+    SudokuSolver::Grid  grid;
+};
+
+enum Stage {
+    STAGE_LOGICAL = 0,
+    STAGE_SOLVE,
+    STAGE_UNIQUE,
+    STAGE_DLX,
+    STAGE_DLX_UNIQUE,
+    STAGE_CDCL,
+    STAGE_CACHED,
+    STAGE_SPLIT,
+    STAGE_TECHNIQUES,
+    STAGE_RATE,
+    STAGE_COUNT
+};
+
+static const char *stageNames [STAGE_COUNT] = { "logical", "solve", "unique", "dlx", "dlx-uniq", "cdcl", "cached",
+                                                "split", "tech", "rate" };
+
+bool loadCorpus (const char *fileName, vector<Puzzle> &puzzles);
+void runStage (SudokuSolver &SS, const vector<Puzzle> &puzzles, int stage, int repeat, const char *name);
+bool runPuzzle (SudokuSolver &SS, const Puzzle &p, int stage, PuzzleCanonizer *canon, SolutionCache *cache);
+BasicSplitSolver<3> &splitSolver (void);
+BasicTechniqueRater<SudokuSolver::Geometry> &rater (void);
+int stageEngine (int stage);
+long checkStage (const vector<Puzzle> &puzzles, int stage);
+long checkPool (const char *fileName, bool lanes);
+bool solvedLogically (SudokuSolver &SS);
+
+int main (int argc, char *argv[]) {
+    const char *defaults [] = { "corpus/easy.txt", "corpus/17clue.txt", "corpus/hardest.txt" };
+    vector<const char *> files;
+    int repeat = 3;
+    bool checkAlloc = false;
+
+    for (int arg = 1; arg < argc; arg++) {
+        if (strcmp (argv[arg], "--repeat") == 0 && arg + 1 < argc)
+            repeat = atoi (argv[++arg]);
+        else if (strcmp (argv[arg], "--check-alloc") == 0)
+            checkAlloc = true;
+        else if (argv[arg][0] == '-') {
+            fprintf (stderr, "Error: Usage: %s [--repeat N] [--check-alloc] [CorpusFile ...]\n", argv[0]);
+            return 1;
+        }
+        else
+            files.push_back (argv[arg]);
+    }
+    if (files.empty ())
+        files.assign (defaults, defaults + 3);
+    if (repeat < 1)
+        repeat = 1;
+
+    if (checkAlloc) {
+        bool clean = true;
+        printf ("%-20s %-8s %12s\n", "corpus", "stage", "allocations");
+        for (size_t f = 0; f < files.size (); f++) {
+            vector<Puzzle> puzzles;
+            if (!loadCorpus (files[f], puzzles)) {
+                fprintf (stderr, "Error: %s could not be read.\n", files[f]);
+                return 1;
+            }
+            const char *name = strrchr (files[f], '/') ? strrchr (files[f], '/') + 1 : files[f];
+            long counts [STAGE_COUNT + 2];
+            for (int stage = 0; stage < STAGE_COUNT; stage++)
+                counts[stage] = checkStage (puzzles, stage);
+            counts[STAGE_COUNT] = checkPool (files[f], false);
+            counts[STAGE_COUNT + 1] = checkPool (files[f], true);
+            for (int k = 0; k < STAGE_COUNT + 2; k++) {
+                printf ("%-20s %-8s %12ld\n", name, k < STAGE_COUNT ? stageNames[k] : k == STAGE_COUNT ? "batch" : "lanes",
+                        counts[k]);
+                clean = clean && counts[k] == 0;
+            }
+        }
+        return clean ? 0 : 1;
+    }
+
+    SudokuSolver SS;
+    const char *kernel;
+    selectCandidateKernel (&kernel);
+    printf ("candidate kernel: %s\n", kernel);
+    printf ("%-20s %-8s %8s %12s %11s %11s %11s %8s\n",
+            "corpus", "stage", "puzzles", "puzzles/s", "median us", "p99 us", "nodes/pz", "solved");
+    for (size_t f = 0; f < files.size (); f++) {
+        vector<Puzzle> puzzles;
+        if (!loadCorpus (files[f], puzzles)) {
+            fprintf (stderr, "Error: %s could not be read.\n", files[f]);
+            return 1;
+        }
+        const char *name = strrchr (files[f], '/') ? strrchr (files[f], '/') + 1 : files[f];
+        for (int stage = 0; stage < STAGE_COUNT; stage++)
+            runStage (SS, puzzles, stage, repeat, name);
+    }
+    return 0;
+}
+
+/*  This function reads every parsable puzzle line of the file.
+ */
+bool loadCorpus (const char *fileName, vector<Puzzle> &puzzles) {
+    int fd = open (fileName, O_RDONLY);
+    if (fd < 0)
+        return false;
+    MappedLineReader in;
+    bool mapped = in.open (fd);
+    close (fd);
+    if (!mapped)
+        return false;
+
+    const char *line;
+    size_t len;
+    Puzzle p;
+    while (in.next (line, len))
+        if (parsePuzzleLine (line, len, p.grid))
+            puzzles.push_back (p);
+    return !puzzles.empty ();
+}
+
+/*  This function times one stage over the corpus and prints its line of
+ *  the report.
+ */
+void runStage (SudokuSolver &SS, const vector<Puzzle> &puzzles, int stage, int repeat, const char *name) {
+    typedef chrono::steady_clock Clock;
+    vector<double> micros;
+    long nodes = 0, solved = 0;
+    SUDOKU_STAT (StatsSummary summary);
+    SolutionCache *cache = stage == STAGE_CACHED ? new SolutionCache (puzzles.size ()) : NULL;
+    PuzzleCanonizer *canon = stage == STAGE_CACHED ? new PuzzleCanonizer : NULL;
+
+    SS.setEngine (stageEngine (stage));
+    SS.techniques = stage == STAGE_TECHNIQUES ? TECH_ALL : 0;
+    micros.reserve (puzzles.size () * repeat);
+    Clock::time_point start = Clock::now ();
+    for (int r = 0; r < repeat; r++)
+        for (size_t k = 0; k < puzzles.size (); k++) {
+            Clock::time_point t0 = Clock::now ();
+            bool ok = runPuzzle (SS, puzzles[k], stage, canon, cache);
+            Clock::time_point t1 = Clock::now ();
+            micros.push_back (chrono::duration<double, micro> (t1 - t0).count ());
+            if (stage != STAGE_LOGICAL && stage != STAGE_RATE)
+                nodes += stage == STAGE_SPLIT ? splitSolver ().nodes : SS.nodes;
+            solved += ok;
+            SUDOKU_STAT (if (stage == STAGE_SOLVE || stage == STAGE_DLX || stage == STAGE_CDCL) summary.add (SS.stats));
+        }
+    double seconds = chrono::duration<double> (Clock::now () - start).count ();
+    delete canon;
+    delete cache;
+
+    sort (micros.begin (), micros.end ());
+    size_t n = micros.size ();
+    printf ("%-20s %-8s %8zu %12.0f %11.2f %11.2f %11.1f %8ld\n",
+            name, stageNames[stage], puzzles.size (), n / seconds,
+            micros[n / 2], micros[min (n - 1, (size_t) (n * 0.99))],
+            (double) nodes / n, solved / repeat);
+    SUDOKU_STAT (if (stage == STAGE_SOLVE || stage == STAGE_DLX || stage == STAGE_CDCL) summary.print (stdout));
+}
+
+/*  This function runs one puzzle through a stage and returns true if the
+ *  stage solved it.
+ */
+bool runPuzzle (SudokuSolver &SS, const Puzzle &p, int stage, PuzzleCanonizer *canon, SolutionCache *cache) {
+    SudokuSolver::Grid out;
+    if (stage == STAGE_LOGICAL)
+        return SS.loadPuzzle (p.grid) && SS.solveLogical () && solvedLogically (SS);
+    if (stage == STAGE_CACHED)
+        return solveCached (SS, *canon, *cache, p.grid, out) == SOLVE_OK;
+    if (stage == STAGE_SPLIT)
+        return splitSolver ().solve (p.grid, out) == SOLVE_OK;
+    if (stage == STAGE_RATE) {
+        uint8_t cells [SudokuSolver::CELLS];
+        for (int k = 0; k < SudokuSolver::CELLS; k++)
+            cells[k] = (uint8_t) p.grid[k / SudokuSolver::NUM][k % SudokuSolver::NUM];
+        return rater ().rate (cells, TECH_ALL) == TECH_SOLVED;
+    }
+    return SS.solve (p.grid, out, stage == STAGE_UNIQUE || stage == STAGE_DLX_UNIQUE) == SOLVE_OK;
+}
+
+/*  This function returns the SplitSolver of the split stage, made with
+ *  its threads on first use.
+ */
+BasicSplitSolver<3> &splitSolver (void) {
+    static BasicSplitSolver<3> *split = NULL;
+    if (split == NULL)
+        split = new BasicSplitSolver<3> ((int) thread::hardware_concurrency ());
+    return *split;
+}
+
+/*  This function returns the rater of the rate stage, made on first use.
+ */
+BasicTechniqueRater<SudokuSolver::Geometry> &rater (void) {
+    static BasicTechniqueRater<SudokuSolver::Geometry> *techniques = NULL;
+    if (techniques == NULL)
+        techniques = new BasicTechniqueRater<SudokuSolver::Geometry>;
+    return *techniques;
+}
+
+/*  This function returns the search engine of a stage.
+ */
+int stageEngine (int stage) {
+    if (stage == STAGE_CDCL)
+        return ENGINE_CDCL;
+    return stage == STAGE_DLX || stage == STAGE_DLX_UNIQUE ? ENGINE_DLX : ENGINE_TAGS;
+}
+
+/*  This function returns the allocations of a pass of the stage over the
+ *  corpus on a solver that has already made one pass.
+ */
+long checkStage (const vector<Puzzle> &puzzles, int stage) {
+    SudokuSolver *SS = new SudokuSolver;
+    SolutionCache *cache = stage == STAGE_CACHED ? new SolutionCache (puzzles.size ()) : NULL;
+    PuzzleCanonizer *canon = stage == STAGE_CACHED ? new PuzzleCanonizer : NULL;
+    long before = 0;
+
+    SS->setEngine (stageEngine (stage));
+    SS->techniques = stage == STAGE_TECHNIQUES ? TECH_ALL : 0;
+    for (int pass = 0; pass < 2; pass++) {
+        before = allocations.load ();
+        for (size_t k = 0; k < puzzles.size (); k++)
+            runPuzzle (*SS, puzzles[k], stage, canon, cache);
+    }
+    long counted = allocations.load () - before;
+    delete canon;
+    delete cache;
+    delete SS;
+    return counted;
+}
+
+/*  This function returns the allocations of a run of a warm two thread
+ *  BatchPool over the file, less those of a run over no input. The output
+ *  goes to /dev/null.
+ */
+long checkPool (const char *fileName, bool lanes) {
+    int fd = open (fileName, O_RDONLY), outFd = open ("/dev/null", O_WRONLY);
+    BatchPool *pool = new BatchPool (2, false, lanes);
+    OutputBuffer *out = new OutputBuffer (outFd);
+    long runs [2] = { 0, 0 };
+
+    for (int pass = 0; pass < 3; pass++) {
+        MappedLineReader in;
+        in.open (fd);
+        long before = allocations.load ();
+        pool->run (in, *out);
+        runs[1] = allocations.load () - before;
+    }
+    MappedLineReader none;
+    long before = allocations.load ();
+    pool->run (none, *out);
+    runs[0] = allocations.load () - before;
+    out->flush ();
+    delete out;
+    delete pool;
+    close (outFd);
+    close (fd);
+    return runs[1] - runs[0];
+}
+
+/*  This function checks that the logical stage left no empty cell.
+ */
+bool solvedLogically (SudokuSolver &SS) {
+    for (int k = 0; k < SS.CELLS; k++)
+        if (SS.board.cells[k] == 0)
+            return false;
+    return true;
+}
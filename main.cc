@@ -6,7 +6,7 @@
  *  Version     :   1.0.1
  *
  *  Created     :   09/04/2011
- *  Modified    :   12/06/2011
+ *  Modified    :   10/14/2026
  *
  *  Description :   This code reads a text file in a specific format and then 
  *                  populates a 2D array. Then it creates an object of the
@@ -31,10 +31,95 @@
  *                  row column value
  *                  row column value
  *                  ...
+ *
+ *                  With --batch the input file holds one puzzle per line
+ *                  (81 characters, '.' or '0' for empty cells, see
+ *                  PuzzleIO.cc) and the output file gets one 81 character
+ *                  solution line per puzzle, in the same order. A puzzle
+ *                  that cannot be solved is written back as it was read
+ *                  and reported on stderr. "-" stands for stdin / stdout.
+ *                  --threads N solves the batch on N worker threads (0 for
+ *                  one per core); the output order does not change.
+ *                  --unique also fails puzzles with more than one solution.
+ *                  --size B solves boards of B x B blocks (3, 4 or 5, the
+ *                  default is 3), their lines have B^4 cells and the
+ *                  values from 10 up are written as letters.
+ *                  --lanes solves 9x9 batches LANES puzzles at a time in
+ *                  vector lanes (see LaneSolver.cc); the puzzles that need
+ *                  a search go on to the scalar solver.
+ *                  --max-nodes N and --timeout-ms N bound the search of each
+ *                  puzzle; a puzzle that runs out fails with "solve limit
+ *                  reached." and is written back as it was read.
+ *                  --cache N keeps the solutions of up to N 9x9 puzzles
+ *                  by canonical form (see SolutionCache.cc), so repeated,
+ *                  relabelled or symmetric copies of a puzzle are looked
+ *                  up instead of solved. It does not go with --lanes.
+ *                  --split solves one puzzle at a time on all the --threads
+ *                  (see SplitSolver.cc): a puzzle that outlasts a short
+ *                  plain solve has the top of its search tree split over
+ *                  the threads. It cuts the time of the hardest puzzles,
+ *                  not that of the batch, and does not go with --lanes or
+ *                  --cache.
+ *                  --packed-in reads a packed binary puzzle file and
+ *                  --packed-out writes packed result records instead of
+ *                  lines (see PackedIO.cc); --packed-stats also stores the
+ *                  search nodes of each puzzle. The block size of a packed
+ *                  input comes from its header. --convert copies the
+ *                  puzzles to the output without solving them, to turn
+ *                  text into packed files and back.
+ *                  --techniques runs the technique passes of
+ *                  TechniqueRater.cc (locked candidates, pairs, triples and
+ *                  X-wings) where the singles stall, before any search.
+ *                  --rate writes a rating line per puzzle instead of its
+ *                  solution: the score and the hardest technique it takes,
+ *                  "search" if the passes are not enough. It reads text or
+ *                  packed input on one thread and writes lines.
+ *
+ *                  --serve ADDRESS runs the resident solver service of
+ *                  SolverService.cc instead, on "unix:PATH", "HOST:PORT"
+ *                  or "PORT". It takes --threads, --unique, --max-nodes,
+ *                  --timeout-ms and --cache like --batch, and no files.
+ *
+ *                  --session runs an interactive SolverSession (see
+ *                  SolverSession.cc) on stdin and stdout. A puzzle line
+ *                  loads a puzzle, "R C N" places N at row R, column C
+ *                  (from 1), "u" takes the last digit back and "h" asks
+ *                  for a hint. Each command is answered with one line:
+ *                  the solve status of the board (0 solvable, 1 not, 2
+ *                  refused, 4 limit reached), or "R C N" for a hint. It
+ *                  takes --max-nodes and --timeout-ms.
+ *
+ *                  --generate N writes N new puzzles with one solution
+ *                  each to the output file, one line per puzzle (see
+ *                  PuzzleGenerator.cc). --band picks their difficulty,
+ *                  easy, medium, hard, expert or MIN-MAX search nodes, and
+ *                  --seed S makes the run repeatable. The clue checks run
+ *                  on --threads threads, one per core by default. It takes
+ *                  --size, --max-nodes and --timeout-ms, and --packed-out
+ *                  or --packed-stats, which stores the search nodes that
+ *                  rate each puzzle.
+ *                  Builds with -DSUDOKU_STATS print solve statistics for
+ *                  the batch on stderr.
  *  
  *  Changelog   :
  *      12/06/2011  :   Added license.
- *                  
+ *      10/14/2026  :   Uses SudokuSolver::solve() and reports its errors.
+ *                      Added the streaming --batch mode.
+ *                      Added --threads for the batch mode.
+ *                      Batch input files are memory mapped.
+ *                      Added --unique for the batch mode.
+ *                      Batch statistics in SUDOKU_STATS builds.
+ *                      Added --size for 16x16 and 25x25 batches.
+ *                      Added --lanes for lane parallel 9x9 batches.
+ *                      Added --max-nodes and --timeout-ms.
+ *                      Added --cache.
+ *                      Added the packed binary format.
+ *                      Output is written in blocks, without endl.
+ *                      Added the --serve mode.
+ *                      Added the --session mode.
+ *                      Added --split.
+ *                      Added the --generate mode.
+ *                      Added --techniques and --rate.
  *
  ******************************************************************************
  */
@@ -42,26 +127,159 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <cstring>
 #include "SudokuSolver.cc"  // The SudokuSolver class.
+#include "PuzzleIO.cc"      // One-line-per-puzzle format.
+#include "BatchPool.cc"     // Multithreaded batch solver.
+#include "StatsSummary.cc"  // Solve statistics.
+#include "LaneSolver.cc"    // Lane parallel logical solver.
+#include "SolutionCache.cc" // Canonical form solution cache.
+#include "PackedIO.cc"      // Packed binary puzzle files.
+#include "OutputBuffer.cc"  // Buffered batch output.
+#include "SolverService.cc" // Resident solver service.
+#include "SolverSession.cc" // Incremental interactive solving.
+#include "SplitSolver.cc"   // Parallel search within one puzzle.
+#include "PuzzleGenerator.cc"   // Puzzle generation.
 
 using namespace std;
 
+/*  Settings of the batch mode, from the command line.
+ */
+struct BatchOptions {
+    int     size;               // Block size of the boards
+    int     threads;            // Worker threads, -1 solves on the calling thread
+    bool    unique;             // Fail puzzles with several solutions
+    bool    lanes;              // Solve in vector lanes (9x9 only)
+    SolveLimits limits;         // Bounds of each solve
+    long    cache;              // Solution cache entries, 0 for none (9x9 only)
+    bool    packedIn;           // The input is a packed file
+    bool    packedOut;          // Write packed records instead of lines
+    bool    packedStats;        // Packed records carry node counts
+    bool    convert;            // Copy the puzzles without solving
+    PackedRecordWriter *packed; // Writer of --packed-out, set up by runBatch
+    bool    split;              // Split the search of each puzzle over the threads
+    long    generate;           // Puzzles to generate, 0 to solve instead
+    GenerateBand band;          // Difficulty of the generated puzzles
+    uint64_t seed;              // Seed of the generator, 0 for the clock
+    int     techniques;         // TechniqueTier passes of every solve
+    bool    rate;               // Write ratings instead of solutions
+};
+
 void openInFile (char *fileName, ifstream &inFile); 
 void openOutFile (char *fileName, ofstream &inFile); 
 void initPuzzle (int (&problemMatrix) [9][9]);
 void printPuzzle (int (&problemMatrix) [9][9]);
 void writeOutFile (char *puzzleName, ofstream &outFile, int (&problemMatrix) [9][9]);
+long runBatch (char *inName, char *outName, BatchOptions &opt);
+void runService (const char *address, const BatchOptions &opt);
+void runSession (const BatchOptions &opt);
+long runGenerate (char *outName, BatchOptions &opt);
+template <int B> long generateLines (OutputBuffer &out, const BatchOptions &opt);
+template <class Reader> long solveSize (Reader &in, OutputBuffer &out, const BatchOptions &opt);
+template <int B, class Reader> long solveLines (Reader &in, OutputBuffer &out, const BatchOptions &opt);
+template <class Reader> long solveLanes (Reader &in, OutputBuffer &out, const BatchOptions &opt);
+template <int B, class Reader> long splitLines (Reader &in, OutputBuffer &out, const BatchOptions &opt);
+template <int B, class Reader> long convertLines (Reader &in, OutputBuffer &out, const BatchOptions &opt);
+template <int B, class Reader> long rateLines (Reader &in, OutputBuffer &out);
+void writeResult (OutputBuffer &out, const BatchOptions &opt, char *line, int cells, int status, long nodes);
+void usage (char *progName);
 
 int main (int argc, char *argv[]) {
     ifstream inFile;
     ofstream outFile;
     int row, col, value;
     int problemMatrix [9][9];
-    
-    if (argc <= 2 || argc > 3) {
-        cerr << "Error: Usage: " << argv[0] << " <InputFilename> <OutputFilename>" << endl;
-        exit(1);
+    bool batch = false, session = false, generating = false;
+    const char *serve = NULL;
+    BatchOptions opt = { 3, -1, false, false, { 0, 0, NULL }, 0, false, false, false, false, NULL, false, 0, { 0, -1 }, 0, 0, false };
+    int arg = 1;
+
+    for (; arg < argc && strncmp (argv[arg], "--", 2) == 0; arg++) {
+        if (strcmp (argv[arg], "--batch") == 0)
+            batch = true;
+        else if (strcmp (argv[arg], "--serve") == 0 && arg + 1 < argc)
+            serve = argv[++arg];
+        else if (strcmp (argv[arg], "--session") == 0)
+            session = true;
+        else if (strcmp (argv[arg], "--threads") == 0 && arg + 1 < argc)
+            opt.threads = atoi (argv[++arg]);
+        else if (strcmp (argv[arg], "--unique") == 0)
+            opt.unique = true;
+        else if (strcmp (argv[arg], "--size") == 0 && arg + 1 < argc)
+            opt.size = atoi (argv[++arg]);
+        else if (strcmp (argv[arg], "--lanes") == 0)
+            opt.lanes = true;
+        else if (strcmp (argv[arg], "--max-nodes") == 0 && arg + 1 < argc)
+            opt.limits.maxNodes = atol (argv[++arg]);
+        else if (strcmp (argv[arg], "--timeout-ms") == 0 && arg + 1 < argc)
+            opt.limits.maxMicros = 1000 * atol (argv[++arg]);
+        else if (strcmp (argv[arg], "--cache") == 0 && arg + 1 < argc)
+            opt.cache = atol (argv[++arg]);
+        else if (strcmp (argv[arg], "--packed-in") == 0)
+            opt.packedIn = true;
+        else if (strcmp (argv[arg], "--packed-out") == 0)
+            opt.packedOut = true;
+        else if (strcmp (argv[arg], "--packed-stats") == 0)
+            opt.packedOut = opt.packedStats = true;
+        else if (strcmp (argv[arg], "--convert") == 0)
+            opt.convert = true;
+        else if (strcmp (argv[arg], "--split") == 0)
+            opt.split = true;
+        else if (strcmp (argv[arg], "--techniques") == 0)
+            opt.techniques = TECH_ALL;
+        else if (strcmp (argv[arg], "--rate") == 0)
+            opt.rate = true;
+        else if (strcmp (argv[arg], "--generate") == 0 && arg + 1 < argc) {
+            opt.generate = atol (argv[++arg]);
+            generating = true;
+        }
+        else if (strcmp (argv[arg], "--band") == 0 && arg + 1 < argc) {
+            if (!parseGenerateBand (argv[++arg], opt.band))
+                usage (argv[0]);
+            generating = true;
+        }
+        else if (strcmp (argv[arg], "--seed") == 0 && arg + 1 < argc) {
+            opt.seed = strtoull (argv[++arg], NULL, 10);
+            generating = true;
+        }
+        else
+            usage (argv[0]);
+    }
+    if (generating) {
+        if (batch || session || serve != NULL || argc - arg != 1 || opt.generate <= 0 || opt.size < 3 || opt.size > 5
+            || opt.unique || opt.lanes || opt.cache != 0 || opt.packedIn || opt.convert || opt.split
+            || opt.techniques != 0 || opt.rate)
+            usage (argv[0]);
+        return runGenerate (argv[arg], opt) ? 1 : 0;
+    }
+    if (session) {
+        if (batch || serve != NULL || argc != arg || opt.threads >= 0 || opt.unique || opt.size != 3 || opt.lanes
+            || opt.cache != 0 || opt.packedIn || opt.packedOut || opt.convert || opt.split
+            || opt.techniques != 0 || opt.rate)
+            usage (argv[0]);
+        runSession (opt);
+        return 0;
     }
+    if (serve != NULL) {
+        if (batch || argc != arg || opt.size != 3 || opt.lanes || opt.cache < 0
+            || opt.packedIn || opt.packedOut || opt.convert || opt.split || opt.techniques != 0 || opt.rate)
+            usage (argv[0]);
+        runService (serve, opt);
+    }
+    if (argc - arg != 2 || opt.size < 3 || opt.size > 5 || (opt.lanes && opt.size != 3)
+        || (opt.cache != 0 && (opt.cache < 0 || opt.lanes || opt.size != 3))
+        || (opt.packedStats && opt.lanes) || (opt.split && (opt.lanes || opt.cache != 0 || opt.techniques != 0))
+        || (opt.rate && (opt.threads >= 0 || opt.unique || opt.lanes || opt.cache != 0 || opt.packedOut
+                         || opt.convert || opt.split || opt.techniques != 0)))
+        usage (argv[0]);
+    if (!batch && (opt.threads >= 0 || opt.unique || opt.size != 3 || opt.lanes
+                   || opt.limits.maxNodes != 0 || opt.limits.maxMicros != 0 || opt.cache != 0
+                   || opt.packedIn || opt.packedOut || opt.convert || opt.split || opt.techniques != 0 || opt.rate))
+        usage (argv[0]);
+    argv += arg - 1;
+
+    if (batch)
+        return runBatch (argv[1], argv[2], opt) ? 1 : 0;
     
     initPuzzle (problemMatrix);    
     
@@ -78,7 +296,17 @@ int main (int argc, char *argv[]) {
     inFile.close();
 
     printPuzzle (problemMatrix);
-    SudokuSolver SS(problemMatrix);
+    SudokuSolver SS;
+    switch (SS.solve (problemMatrix, problemMatrix)) {
+        case SOLVE_OK:
+            break;
+        case SOLVE_INVALID:
+            cerr << "Error: Puzzle has conflicting values." << endl;
+            exit (1);
+        default:
+            cerr << "Error: Puzzle cannot  be solved." << endl;
+            exit (1);
+    }
     printPuzzle (problemMatrix);
 
     openOutFile (argv[2], outFile);
@@ -94,20 +322,24 @@ void initPuzzle (int (&problemMatrix) [9][9]) {
             problemMatrix [i][j] = 0;
 }
 
+/*  The board is put together in a string and handed to cout in one go,
+ *  without flushing every row.
+ */
 void printPuzzle (int (&problemMatrix) [9][9]) {
-    cout << "-------------------------------------------------------" << endl;
+    const string rule = "-------------------------------------------------------\n";
+    string text = rule;
     for (int row = 0; row < 9; row++) {
-        cout << "| ";
+        text += "| ";
         for (int col = 0; col < 9; col++) {
-            cout << " *" << problemMatrix[row][col] << "* ";
+            text += " *" + to_string (problemMatrix[row][col]) + "* ";
             if (!((col+1) % 3))
-                cout << " | ";
+                text += " | ";
         }
+        text += '\n';
         if (!((row+1) % 3))
-            cout << endl << "-------------------------------------------------------" << endl;
-        else
-            cout << endl;
+            text += rule;
     }
+    cout << text;
 }
 
 void openInFile (char *fileName, ifstream &inFile) {
@@ -118,7 +350,7 @@ void openInFile (char *fileName, ifstream &inFile) {
     }
 
     else {
-        cout << "File opened successfully" << endl;
+        cout << "File opened successfully\n";
     }
 }
 
@@ -130,24 +362,434 @@ void openOutFile (char *fileName, ofstream &inFile) {
     }
 
     else {
-        cout << "File opened successfully" << endl;
+        cout << "File opened successfully\n";
     }
 }
 
+/*  Like printPuzzle, the board is written with one call and the file is
+ *  only flushed when it is closed.
+ */
 void writeOutFile (char *puzzleName, ofstream &outFile, int (&problemMatrix) [9][9]) {
-    outFile << puzzleName << endl;
-    //outFile << "-------------------------------------------------------" << endl;
+    string text = string (puzzleName) + '\n';
+    //text += "-------------------------------------------------------\n";
     for (int row = 0; row < 9; row++) {
-        //outFile << "| ";
+        //text += "| ";
         for (int col = 0; col < 9; col++) {
-            outFile << " *" << problemMatrix[row][col] << "* ";
+            text += " *" + to_string (problemMatrix[row][col]) + "* ";
             if (!((col+1) % 3) && col != 8)
-                outFile << " | ";
+                text += " | ";
         }
+        text += '\n';
         if (!((row+1) % 3) && row != 8)
-            outFile << endl << "---------------------------------------------------" << endl;
+            text += "---------------------------------------------------\n";
+    }
+    outFile << text;
+}
+
+void usage (char *progName) {
+    cerr << "Error: Usage: " << progName
+         << " [--batch [--threads N] [--unique] [--size 3|4|5] [--lanes] [--max-nodes N] [--timeout-ms N]"
+         << " [--cache N] [--packed-in] [--packed-out] [--packed-stats] [--convert] [--split] [--techniques]"
+         << " [--rate]]"
+         << " <InputFilename> <OutputFilename>" << endl
+         << "       " << progName
+         << " --serve ADDRESS [--threads N] [--unique] [--max-nodes N] [--timeout-ms N] [--cache N]" << endl
+         << "       " << progName << " --session [--max-nodes N] [--timeout-ms N]" << endl
+         << "       " << progName
+         << " --generate N [--band easy|medium|hard|expert|MIN-MAX] [--seed S] [--threads N] [--size 3|4|5]"
+         << " [--max-nodes N] [--timeout-ms N] [--packed-out] [--packed-stats] <OutputFilename>" << endl;
+    exit (1);
+}
+
+/*  This function solves every puzzle line of the input file and writes one
+ *  solution line per puzzle to the output file. A regular input file is
+ *  memory mapped and parsed in place, anything else is read through stdio.
+ *  The results are collected in an OutputBuffer and written in 1 MB
+ *  blocks, without a flush per line.
+ *  With threads < 0 a single solver is reused for all the puzzles on this
+ *  thread, otherwise the puzzles go to a BatchPool (0 asks for one thread
+ *  per core). With 'unique' a puzzle with several solutions fails too.
+ *  'size' is the block size of the boards and 'lanes' runs 9x9 puzzles
+ *  through LaneSolvers. 'limits' bound every solve and 'cache' sets up a
+ *  SolutionCache of that many entries. 'packedIn' reads a packed file,
+ *  whose block size replaces 'size', and 'packedOut' writes packed
+ *  records. Empty lines are skipped. It returns the number of puzzles
+ *  that failed.
+ */
+long runBatch (char *inName, char *outName, BatchOptions &opt) {
+    static char inBuf [1 << 20];
+    long failed;
+
+    FILE *in = strcmp (inName, "-") ? fopen (inName, "r") : stdin;
+    int outFd = strcmp (outName, "-") ? open (outName, O_WRONLY | O_CREAT | O_TRUNC, 0666) : STDOUT_FILENO;
+    if (in == NULL || outFd < 0) {
+        cerr << "Error: File could not be opened." << endl;
+        exit (1);
+    }
+    setvbuf (in, inBuf, _IOFBF, sizeof (inBuf));
+    OutputBuffer out (outFd);
+    if (opt.threads == 0)
+        opt.threads = std::thread::hardware_concurrency ();
+
+    PackedRecordReader packedIn (in);
+    if (opt.packedIn) {
+        if (!packedIn.open ()) {
+            cerr << "Error: Input is not a packed puzzle file." << endl;
+            exit (1);
+        }
+        opt.size = packedIn.header.block;
+        if (opt.size != 3 && (opt.lanes || opt.cache != 0)) {
+            cerr << "Error: --lanes and --cache only take 9x9 puzzles." << endl;
+            exit (1);
+        }
+    }
+    if (opt.packedOut)
+        opt.packed = new PackedRecordWriter (out, opt.size, opt.packedStats ? PACKED_STATS : 0);
+
+    MappedLineReader mapped;
+    if (opt.packedIn) {
+        failed = solveSize (packedIn, out, opt);
+    }
+    else if (mapped.open (fileno (in))) {
+        failed = solveSize (mapped, out, opt);
+    }
+    else {
+        StdioLineReader stream (in);
+        failed = solveSize (stream, out, opt);
+    }
+
+    delete opt.packed;
+    opt.packed = NULL;
+    if (in != stdin)
+        fclose (in);
+    if (!out.flush () || (outFd != STDOUT_FILENO && close (outFd) != 0)) {
+        cerr << "Error: Output could not be written." << endl;
+        exit (1);
+    }
+    return failed;
+}
+
+/*  This function runs the solver service on 'address' with the batch
+ *  settings that apply to it. It only comes back if the socket fails, and
+ *  then exits.
+ */
+void runService (const char *address, const BatchOptions &opt) {
+    SolverService service (opt.threads > 0 ? opt.threads : (int) std::thread::hardware_concurrency (), opt.unique);
+    service.limits = opt.limits;
+    if (opt.cache > 0)
+        service.cache = new SolutionCache (opt.cache);
+    if (!service.listen (address)) {
+        cerr << "Error: Cannot listen on " << address << "." << endl;
+        exit (1);
+    }
+    service.run ();
+    cerr << "Error: Connections could not be accepted." << endl;
+    exit (1);
+}
+
+/*  This function runs an interactive session, one command per line of
+ *  stdin and one answer per line of stdout. Answers are flushed at once,
+ *  the other side waits for them.
+ */
+void runSession (const BatchOptions &opt) {
+    SolverSession *session = new SolverSession;
+    session->SS.limits = opt.limits;
+    StdioLineReader in (stdin);
+    const char *line;
+    size_t len;
+
+    while (in.next (line, len)) {
+        SudokuSolver::Grid grid;
+        int row, col, value;
+        if (parsePuzzleLine (line, len, grid))
+            cout << session->load (grid) << endl;
+        else if (line[0] == 'u')
+            cout << (session->undo () ? session->status () : (int) SOLVE_INVALID) << endl;
+        else if (line[0] == 'h') {
+            if (session->hint (row, col, value))
+                cout << row + 1 << ' ' << col + 1 << ' ' << value << endl;
+            else
+                cout << session->status () << endl;
+        }
+        else if (sscanf (line, "%d %d %d", &row, &col, &value) == 3)
+            cout << session->place (row - 1, col - 1, value) << endl;
         else
-            outFile << endl;
+            cout << (int) SOLVE_INVALID << endl;
+    }
+    delete session;
+}
+
+/*  This function writes opt.generate new puzzles to the output file, as
+ *  lines or as packed records, like runBatch writes its results. It
+ *  returns the number of puzzles that could not be made in the band.
+ */
+long runGenerate (char *outName, BatchOptions &opt) {
+    int outFd = strcmp (outName, "-") ? open (outName, O_WRONLY | O_CREAT | O_TRUNC, 0666) : STDOUT_FILENO;
+    if (outFd < 0) {
+        cerr << "Error: File could not be opened." << endl;
+        exit (1);
+    }
+    OutputBuffer out (outFd);
+    if (opt.threads <= 0)
+        opt.threads = std::thread::hardware_concurrency ();
+    if (opt.seed == 0)
+        opt.seed = (uint64_t) std::chrono::system_clock::now ().time_since_epoch ().count ();
+    if (opt.packedOut)
+        opt.packed = new PackedRecordWriter (out, opt.size, opt.packedStats ? PACKED_STATS : 0);
+
+    long failed;
+    switch (opt.size) {
+        case 4:     failed = generateLines<4> (out, opt); break;
+        case 5:     failed = generateLines<5> (out, opt); break;
+        default:    failed = generateLines<3> (out, opt); break;
+    }
+
+    delete opt.packed;
+    opt.packed = NULL;
+    if (!out.flush () || (outFd != STDOUT_FILENO && close (outFd) != 0)) {
+        cerr << "Error: Output could not be written." << endl;
+        exit (1);
+    }
+    return failed;
+}
+
+/*  This function runs the generator for one block size, see runGenerate.
+ */
+template <int B>
+long generateLines (OutputBuffer &out, const BatchOptions &opt) {
+    typedef BasicPuzzleGenerator<B> Generator;
+    Generator *gen = new Generator (opt.threads, opt.seed);
+    gen->band = opt.band;
+    gen->limits = opt.limits;
+    long failed = 0;
+    for (long k = 0; k < opt.generate; k++) {
+        typename Generator::Grid grid;
+        char line [Generator::CELLS + 1];
+        if (gen->generate (grid) != SOLVE_OK) {
+            cerr << "Error: puzzle " << k + 1 << ": no puzzle in the band after "
+                 << gen->tries << " grids." << endl;
+            failed++;
+            continue;
+        }
+        formatPuzzleLine (grid, line);
+        writeResult (out, opt, line, Generator::CELLS, SOLVE_OK, gen->rating);
+    }
+    delete gen;
+    return failed;
+}
+
+/*  This function picks the solver instance for the block size.
+ */
+template <class Reader>
+long solveSize (Reader &in, OutputBuffer &out, const BatchOptions &opt) {
+    switch (opt.size) {
+        case 4:     return solveLines<4> (in, out, opt);
+        case 5:     return solveLines<5> (in, out, opt);
+        default:    return solveLines<3> (in, out, opt);
+    }
+}
+
+/*  This function runs the batch over one reader, see runBatch.
+ */
+template <int B, class Reader>
+long solveLines (Reader &in, OutputBuffer &out, const BatchOptions &opt) {
+    typedef BasicSudokuSolver<B> Solver;
+    bool unique = opt.unique;
+    if (opt.convert)
+        return convertLines<B> (in, out, opt);
+    if (opt.split)
+        return splitLines<B> (in, out, opt);
+    if (opt.rate)
+        return rateLines<B> (in, out);
+    SolutionCache *cache = opt.cache > 0 ? new SolutionCache (opt.cache) : NULL;
+    if (opt.threads > 0) {
+        BasicBatchPool<B> pool (opt.threads, unique, opt.lanes);
+        pool.limits = opt.limits;
+        pool.techniques = opt.techniques;
+        pool.cache = cache;
+        pool.packed = opt.packed;
+        long failed = pool.run (in, out);
+        SUDOKU_STAT (pool.summary.print (stderr));
+        delete cache;
+        return failed;
+    }
+    if (opt.lanes)
+        return solveLanes (in, out, opt);
+
+    SUDOKU_STAT (StatsSummary summary);
+    Solver SS;
+    PuzzleCanonizer *canon = cache != NULL ? new PuzzleCanonizer : NULL;
+    SS.limits = opt.limits;
+    SS.techniques = opt.techniques;
+    const char *line;
+    size_t len;
+    long failed = 0;
+    while (in.next (line, len)) {
+        char result [Solver::CELLS + 1];
+        int status = solveCachedLine (SS, canon, cache, line, len, result, unique);
+        if (status != SOLVE_OK) {
+            char where [96];
+            cerr << "Error: line " << in.lineNo << ": " << statusMessage (status)
+                 << describeConflict<Solver::NUM> (SS.conflict, where, sizeof (where)) << endl;
+            failed++;
+        }
+        writeResult (out, opt, result, Solver::CELLS, status, status != SOLVE_INVALID ? SS.nodes : 0);
+        SUDOKU_STAT (if (status != SOLVE_INVALID) summary.add (SS.stats));
     }
+    SUDOKU_STAT (summary.print (stderr));
+    delete canon;
+    delete cache;
+    return failed;
 }
 
+/*  This function is the single thread lane mode: it reads LANES puzzle
+ *  lines at a time and solves them on one LaneSolver. Lines of an
+ *  unstable reader are copied first, the next read overwrites them.
+ */
+template <class Reader>
+long solveLanes (Reader &in, OutputBuffer &out, const BatchOptions &opt) {
+    LaneSolver LS;
+    LS.scalar.limits = opt.limits;
+    LS.scalar.techniques = opt.techniques;
+    static char text [LANES][PUZZLE_LINE_CELLS], result [LANES * (PUZZLE_LINE_CELLS + 1)];
+    const char *lines [LANES];
+    uint16_t lengths [LANES];
+    long lineNo [LANES];
+    uint8_t status [LANES];
+    SolveConflict conflict [LANES];
+    long failed = 0;
+    bool more = true;
+
+    while (more) {
+        const char *line;
+        size_t len;
+        int n = 0;
+        while (n < LANES && (more = in.next (line, len))) {
+            if (len > PUZZLE_LINE_CELLS)
+                len = PUZZLE_LINE_CELLS;
+            if (!Reader::STABLE) {
+                memcpy (text[n], line, len);
+                line = text[n];
+            }
+            lines[n] = line;
+            lengths[n] = (uint16_t) len;
+            lineNo[n++] = in.lineNo;
+        }
+        if (n == 0)
+            break;
+        solveLaneLines (LS, lines, lengths, n, result, PUZZLE_LINE_CELLS + 1, status, opt.unique, conflict);
+        for (int k = 0; k < n; k++) {
+            if (status[k] != SOLVE_OK) {
+                char where [96];
+                cerr << "Error: line " << lineNo[k] << ": " << statusMessage (status[k])
+                     << describeConflict<SudokuSolver::NUM> (conflict[k], where, sizeof (where)) << endl;
+                failed++;
+            }
+            writeResult (out, opt, result + k * (PUZZLE_LINE_CELLS + 1), PUZZLE_LINE_CELLS, status[k], 0);
+        }
+    }
+    return failed;
+}
+
+/*  This function is the --split mode: the puzzles go one at a time to a
+ *  SplitSolver on all the threads (one per core unless --threads says).
+ */
+template <int B, class Reader>
+long splitLines (Reader &in, OutputBuffer &out, const BatchOptions &opt) {
+    typedef BasicSplitSolver<B> Solver;
+    Solver *split = new Solver (opt.threads > 0 ? opt.threads : (int) std::thread::hardware_concurrency ());
+    split->limits = opt.limits;
+    SUDOKU_STAT (StatsSummary summary);
+    const char *line;
+    size_t len;
+    long failed = 0;
+    while (in.next (line, len)) {
+        char result [Solver::CELLS + 1];
+        int status = solvePuzzleLine (*split, line, len, result, opt.unique);
+        if (status != SOLVE_OK) {
+            char where [96];
+            cerr << "Error: line " << in.lineNo << ": " << statusMessage (status)
+                 << describeConflict<Solver::NUM> (split->conflict, where, sizeof (where)) << endl;
+            failed++;
+        }
+        writeResult (out, opt, result, Solver::CELLS, status, status != SOLVE_INVALID ? split->nodes : 0);
+        SUDOKU_STAT (if (status != SOLVE_INVALID) summary.add (split->stats));
+    }
+    SUDOKU_STAT (summary.print (stderr));
+    delete split;
+    return failed;
+}
+
+/*  This function is the --convert mode: it copies every puzzle line to
+ *  the output as it was read, cut or padded to a board.
+ */
+template <int B, class Reader>
+long convertLines (Reader &in, OutputBuffer &out, const BatchOptions &opt) {
+    const int cells = B * B * B * B;
+    char result [cells + 1];
+    const char *line;
+    size_t len;
+    while (in.next (line, len)) {
+        echoPuzzleLine<B * B> (line, len, result);
+        writeResult (out, opt, result, cells, SOLVE_OK, 0);
+    }
+    return 0;
+}
+
+/*  This function is the --rate mode: it runs every technique pass on each
+ *  puzzle and writes "SCORE TECHNIQUE" lines, see TechniqueRater.cc. A
+ *  puzzle that cannot be read or solved gets "0 none". The solver loads
+ *  each puzzle first, so clashing givens and dead ends are reported with
+ *  the cells at fault like the other batch modes do.
+ */
+template <int B, class Reader>
+long rateLines (Reader &in, OutputBuffer &out) {
+    typedef BasicSudokuSolver<B> Solver;
+    Solver *SS = new Solver;
+    BasicTechniqueRater<typename Solver::Geometry> *rater = new BasicTechniqueRater<typename Solver::Geometry>;
+    SS->techniques = TECH_ALL;
+    const char *line;
+    size_t len;
+    long failed = 0;
+    while (in.next (line, len)) {
+        typename Solver::Grid grid;
+        uint8_t cells [Solver::CELLS];
+        char result [32];
+        int status = SOLVE_INVALID;
+        SS->conflict = SolveConflict { -1, -1, -1, 0 };
+        if (parsePuzzleLine (line, len, grid) && SS->loadPuzzle (grid)) {
+            for (int k = 0; k < Solver::CELLS; k++)
+                cells[k] = (uint8_t) grid[k / Solver::NUM][k % Solver::NUM];
+            status = SOLVE_OK;
+            if (rater->rate (cells, TECH_ALL) == TECH_DEAD) {
+                status = SOLVE_UNSOLVABLE;
+                if (!SS->solveLogical () || !SS->solveTechniques ())
+                    SS->findDeadEnd ();
+            }
+        }
+        if (status != SOLVE_OK) {
+            char where [96];
+            cerr << "Error: line " << in.lineNo << ": " << statusMessage (status)
+                 << describeConflict<Solver::NUM> (SS->conflict, where, sizeof (where)) << endl;
+            failed++;
+        }
+        int n = snprintf (result, sizeof (result), "%ld %s\n", status == SOLVE_OK ? rater->score : 0L,
+                          status == SOLVE_OK ? techniqueName (rater->level) : "none");
+        out.put (result, n);
+    }
+    delete rater;
+    delete SS;
+    return failed;
+}
+
+/*  This function writes one result of 'cells' characters to the output,
+ *  as a packed record or as a line. 'line' has room for the newline.
+ */
+void writeResult (OutputBuffer &out, const BatchOptions &opt, char *line, int cells, int status, long nodes) {
+    if (opt.packed != NULL) {
+        opt.packed->put (line, status, nodes);
+        return;
+    }
+    line[cells] = '\n';
+    out.put (line, cells + 1);
+}